@@ -31,6 +31,7 @@ extern "C" {
 #include <stdint.h>
 
 typedef int32_t  mga_i32;
+typedef int64_t  mga_i64;
 typedef uint8_t  mga_u8;
 typedef uint32_t mga_u32;
 typedef uint64_t mga_u64;
@@ -41,18 +42,46 @@ typedef mga_i32 mga_b32;
 #define MGA_MiB(x) (mga_u64)((mga_u64)(x) << 20)
 #define MGA_GiB(x) (mga_u64)((mga_u64)(x) << 30) 
 
+typedef enum {
+    // The low level backend if the platform has one, otherwise the malloc backend
+    MGA_BACKEND_DEFAULT = 0,
+    MGA_BACKEND_RESERVE,
+    MGA_BACKEND_MALLOC,
+    // The low level backend with the functions of mga_desc.mem_funcs
+    MGA_BACKEND_CUSTOM
+} mga_backend;
+
+// Same as the MGA_MEM_* options, see the platforms section of the docs
+typedef struct {
+    void* (*reserve)(mga_u64 size);
+    mga_b32 (*commit)(void* ptr, mga_u64 size);
+    void (*decommit)(void* ptr, mga_u64 size);
+    void (*release)(void* ptr, mga_u64 size);
+} mga_mem_funcs;
+
+// The data of a node is in the same allocation, right after the node
 typedef struct _mga_malloc_node {
     struct _mga_malloc_node* prev;
+    // Arena position of the first byte of data
+    mga_u64 start;
     mga_u64 size;
-    mga_u64 pos;
     mga_u8* data;
 } _mga_malloc_node;
 
 typedef struct {
     _mga_malloc_node* cur_node;
+
+    // Popped nodes are kept for the next pushes, up to MGA_MALLOC_NODE_CACHE
+    _mga_malloc_node* free_nodes;
+    mga_u32 num_free_nodes;
 } _mga_malloc_backend;
 typedef struct {
     mga_u64 commit_pos;
+    mga_u64 top_pos;
+    mga_u64 top_commit_pos;
+    // Pops do not decommit memory, used for scratch arenas
+    mga_b32 retain_commit;
+    mga_mem_funcs mem;
 } _mga_reserve_backend;
 
 typedef enum {
@@ -61,29 +90,43 @@ typedef enum {
     MGA_ERR_MALLOC_FAILED,
     MGA_ERR_COMMIT_FAILED,
     MGA_ERR_OUT_OF_MEMORY,
-    MGA_ERR_CANNOT_POP_MORE
+    MGA_ERR_CANNOT_POP_MORE,
+    MGA_ERR_UNSUPPORTED,
+    MGA_ERR_FILE_FAILED
 } mga_error_code;
 
 typedef struct {
     mga_error_code code;
-    char* msg;
+    const char* msg;
 } mga_error;
 
 typedef void (mga_error_callback)(mga_error error);
 
+typedef struct mga_timeline mga_timeline;
+
 
 typedef struct {
     mga_u64 _pos;
+    // Position of the first allocation
+    mga_u64 _start_pos;
+
+    // Pushes that end before _fast_limit are done inline at _fast_base + pos
+    mga_u64 _fast_limit;
+    mga_u8* _fast_base;
 
     mga_u64 _size;
     mga_u64 _block_size;
     mga_u32 _align;
+    mga_u32 _backend;
 
     union {
         _mga_malloc_backend _malloc_backend;
         _mga_reserve_backend _reserve_backend;
     };
 
+    // Sampled on every commit and decommit, see mga_timeline_create
+    mga_timeline* _timeline;
+
     mga_error _last_error;
     mga_error_callback* error_callback;
 } mg_arena;
@@ -93,9 +136,21 @@ typedef struct {
     mga_u32 desired_block_size;
     mga_u32 align;
     mga_error_callback* error_callback;
+    mga_backend backend;
+    // Only used by MGA_BACKEND_CUSTOM
+    const mga_mem_funcs* mem_funcs;
+    // Offsets the first allocation by a rotating multiple of MGA_CACHE_LINE,
+    // so arenas used at the same time do not start in the same cache sets
+    mga_b32 cache_color;
 } mga_desc;
 
 MGA_FUNC_DEF mg_arena* mga_create(const mga_desc* desc);
+// Creates an arena inside of buffer. Nothing is committed, allocated, or released
+// by the arena, so destroying it is optional. desired_max_size and backend are ignored
+MGA_FUNC_DEF mg_arena* mga_create_from_buffer(const mga_desc* desc, void* buffer, mga_u64 size);
+// Creates an arena with size bytes of memory pushed onto parent.
+// It is released with the memory of the parent, like any other allocation
+MGA_FUNC_DEF mg_arena* mga_create_sub(mg_arena* parent, mga_u64 size);
 MGA_FUNC_DEF void mga_destroy(mg_arena* arena);
 
 MGA_FUNC_DEF mga_error mga_get_error(mg_arena* arena);
@@ -104,31 +159,408 @@ MGA_FUNC_DEF mga_u64 mga_get_pos(mg_arena* arena);
 MGA_FUNC_DEF mga_u64 mga_get_size(mg_arena* arena);
 MGA_FUNC_DEF mga_u32 mga_get_block_size(mg_arena* arena);
 MGA_FUNC_DEF mga_u32 mga_get_align(mg_arena* arena);
+// Bytes of memory that the arena holds, including the cached nodes of the malloc backend
+MGA_FUNC_DEF mga_u64 mga_get_committed(mg_arena* arena);
 
-MGA_FUNC_DEF void* mga_push(mg_arena* arena, mga_u64 size);
 MGA_FUNC_DEF void* mga_push_zero(mg_arena* arena, mga_u64 size);
 
+#ifndef MGA_STREAM_THRESHOLD
+#   define MGA_STREAM_THRESHOLD MGA_MiB(1)
+#endif
+
+// Pushes size bytes and copies src into them. Copies of at least
+// MGA_STREAM_THRESHOLD bytes use non-temporal stores, so they do not evict the cache
+MGA_FUNC_DEF void* mga_push_copy(mg_arena* arena, const void* src, mga_u64 size);
+
+// Pushes count allocations with one bounds check and at most one commit.
+// out_ptrs is filled with the allocations, or with NULL on failure
+MGA_FUNC_DEF mga_b32 mga_push_batch(mg_arena* arena, const mga_u64* sizes, mga_u32 count, void** out_ptrs);
+
+// Makes sure that the next size bytes can be pushed without the slow path
+MGA_FUNC_DEF mga_b32 mga_prepare(mg_arena* arena, mga_u64 size);
+
+// Called by mga_push when memory needs to be committed or allocated
+MGA_FUNC_DEF void* _mga_push_slow(mg_arena* arena, mga_u64 size, mga_u32 align);
+
+#ifndef MGA_INLINE
+#   if defined(_MSC_VER) && !defined(__cplusplus)
+#       define MGA_INLINE static __inline
+#   else
+#       define MGA_INLINE static inline
+#   endif
+#endif
+
+// Aligns the address of the position, not the position itself,
+// because the malloc backend does not keep positions and addresses aligned
+MGA_INLINE mga_u64 _mga_align_pos(mg_arena* arena, mga_u32 align) {
+    mga_u64 addr = (mga_u64)(uintptr_t)arena->_fast_base + arena->_pos;
+    return arena->_pos + ((0 - addr) & ((mga_u64)align - 1));
+}
+
+// align has to be a power of 2
+MGA_INLINE void* mga_push_aligned(mg_arena* arena, mga_u64 size, mga_u32 align) {
+    mga_u64 pos_aligned = _mga_align_pos(arena, align);
+    mga_u64 limit = arena->_fast_limit;
+
+    if (pos_aligned <= limit && size <= limit - pos_aligned) {
+        arena->_pos = pos_aligned + size;
+        return (void*)(arena->_fast_base + pos_aligned);
+    }
+
+    return _mga_push_slow(arena, size, align);
+}
+
+MGA_INLINE void* mga_push(mg_arena* arena, mga_u64 size) {
+    return mga_push_aligned(arena, size, arena->_align);
+}
+
+// No bounds checks at all. Only use this after mga_prepare,
+// and include the alignment padding of every push in the prepared size
+MGA_INLINE void* mga_push_unchecked(mg_arena* arena, mga_u64 size) {
+    mga_u64 pos_aligned = _mga_align_pos(arena, arena->_align);
+    arena->_pos = pos_aligned + size;
+
+    return (void*)(arena->_fast_base + pos_aligned);
+}
+
+#ifndef MGA_CACHE_LINE
+#   define MGA_CACHE_LINE 64
+#endif
+
+// Aligned to MGA_CACHE_LINE, and padded so nothing else shares the cache lines
+MGA_FUNC_DEF void* mga_push_cache_line(mg_arena* arena, mga_u64 size);
+// Aligned to the page size and padded to whole pages
+MGA_FUNC_DEF void* mga_push_page(mg_arena* arena, mga_u64 size);
+
 MGA_FUNC_DEF void mga_pop(mg_arena* arena, mga_u64 size);
 MGA_FUNC_DEF void mga_pop_to(mg_arena* arena, mga_u64 pos);
 
 MGA_FUNC_DEF void mga_reset(mg_arena* arena);
 
+// Allocations from the top of the arena, growing downwards
+// Only supported by the low level backend
+MGA_FUNC_DEF mga_u64 mga_get_top_pos(mg_arena* arena);
+
+MGA_FUNC_DEF void* mga_push_top(mg_arena* arena, mga_u64 size);
+MGA_FUNC_DEF void* mga_push_top_zero(mg_arena* arena, mga_u64 size);
+
+MGA_FUNC_DEF void mga_pop_top_to(mg_arena* arena, mga_u64 top_pos);
+MGA_FUNC_DEF void mga_reset_top(mg_arena* arena);
+
 #define MGA_PUSH_STRUCT(arena, type) (type*)mga_push(arena, sizeof(type))
 #define MGA_PUSH_ZERO_STRUCT(arena, type) (type*)mga_push_zero(arena, sizeof(type))
 #define MGA_PUSH_ARRAY(arena, type, num) (type*)mga_push(arena, sizeof(type) * (num))
 #define MGA_PUSH_ZERO_ARRAY(arena, type, num) (type*)mga_push_zero(arena, sizeof(type) * (num))
 
+// Grows ptr from old_size to new_size bytes without moving it.
+// Only works if ptr is the last allocation of the arena, and it fails
+// for the malloc backend if the new size does not fit in the current node
+MGA_FUNC_DEF mga_b32 mga_extend(mg_arena* arena, void* ptr, mga_u64 old_size, mga_u64 new_size);
+
+#define MGA_PUSH_UNCHECKED_STRUCT(arena, type) (type*)mga_push_unchecked(arena, sizeof(type))
+#define MGA_PUSH_UNCHECKED_ARRAY(arena, type, num) (type*)mga_push_unchecked(arena, sizeof(type) * (num))
+
+#define MGA_PUSH_TOP_STRUCT(arena, type) (type*)mga_push_top(arena, sizeof(type))
+#define MGA_PUSH_TOP_ZERO_STRUCT(arena, type) (type*)mga_push_top_zero(arena, sizeof(type))
+#define MGA_PUSH_TOP_ARRAY(arena, type, num) (type*)mga_push_top(arena, sizeof(type) * (num))
+#define MGA_PUSH_TOP_ZERO_ARRAY(arena, type, num) (type*)mga_push_top_zero(arena, sizeof(type) * (num))
+
 typedef struct {
     mg_arena* arena;
     mga_u64 _pos;
+    // One plus the index of the scratch arena that this marked as in use, or 0
+    mga_u32 _scratch_index;
 } mga_temp;
 
 MGA_FUNC_DEF mga_temp mga_temp_begin(mg_arena* arena);
 MGA_FUNC_DEF void mga_temp_end(mga_temp temp);
 
 MGA_FUNC_DEF void mga_scratch_set_desc(const mga_desc* desc);
+// Sets the number of scratch arenas of the current thread, up to MGA_SCRATCH_MAX.
+// Arenas are only created when they are needed
+MGA_FUNC_DEF void mga_scratch_set_count(mga_u32 count);
+// Gets a scratch arena that is not in use and not in conflicts
 MGA_FUNC_DEF mga_temp mga_scratch_get(mg_arena** conflicts, mga_u32 num_conflicts);
 MGA_FUNC_DEF void mga_scratch_release(mga_temp scratch);
+// Scratch arenas keep their committed memory when they are released.
+// This decommits the memory of the scratch arenas that are not in use
+MGA_FUNC_DEF void mga_scratch_shrink(void);
+// Destroys the scratch arenas of the current thread.
+// This is called automatically when a thread exits, see MGA_NO_SCRATCH_CLEANUP
+MGA_FUNC_DEF void mga_scratch_destroy(void);
+// Highest total usage of the scratch arenas of the current thread, in bytes,
+// measured whenever a scratch arena is released
+MGA_FUNC_DEF mga_u64 mga_scratch_get_peak(void);
+MGA_FUNC_DEF void mga_scratch_reset_peak(void);
+
+// Ring buffer mapped twice back to back, so every allocation is contiguous,
+// even when it wraps around the end of the buffer.
+// Safe to use with one producer thread and one consumer thread.
+typedef struct {
+    mga_u8* _data;
+    mga_u64 _size;
+    mga_u32 _align;
+    void* _handle;
+
+    mga_error_callback* error_callback;
+
+    // Producer and consumer state are kept on separate cache lines.
+    // Each side has its own error, so errors on both threads do not race
+    mga_u8 _pad0[64];
+    mga_u64 _write_pos;
+    mga_u64 _head;
+    mga_error _producer_error;
+    mga_u8 _pad1[64];
+    mga_u64 _tail;
+    mga_error _consumer_error;
+} mga_ring;
+
+typedef struct {
+    mga_u64 desired_size;
+    mga_u32 align;
+    mga_error_callback* error_callback;
+} mga_ring_desc;
+
+MGA_FUNC_DEF mga_ring* mga_ring_create(const mga_ring_desc* desc);
+MGA_FUNC_DEF void mga_ring_destroy(mga_ring* ring);
+
+// Gets the error of mga_ring_create when ring is NULL. Otherwise it gets the producer
+// error, or the consumer error if there is none, and should only be called
+// while neither thread uses the ring
+MGA_FUNC_DEF mga_error mga_ring_get_error(mga_ring* ring);
+MGA_FUNC_DEF mga_u64 mga_ring_get_size(mga_ring* ring);
+
+// Producer functions
+MGA_FUNC_DEF mga_error mga_ring_get_producer_error(mga_ring* ring);
+MGA_FUNC_DEF mga_u64 mga_ring_get_free(mga_ring* ring);
+MGA_FUNC_DEF void* mga_ring_push(mga_ring* ring, mga_u64 size);
+MGA_FUNC_DEF void mga_ring_publish(mga_ring* ring);
+
+// Consumer functions
+MGA_FUNC_DEF mga_error mga_ring_get_consumer_error(mga_ring* ring);
+MGA_FUNC_DEF void* mga_ring_peek(mga_ring* ring, mga_u64* available);
+MGA_FUNC_DEF void mga_ring_release(mga_ring* ring, mga_u64 size);
+
+// Handles stay valid until their element is removed.
+// The zero handle is never valid
+typedef struct {
+    mga_u32 index;
+    mga_u32 generation;
+} mga_slot_handle;
+
+typedef struct {
+    // Index of the element, or the next free slot.
+    // Odd generations are in use, even generations are free
+    mga_u32 index;
+    mga_u32 generation;
+} _mga_slot;
+
+// Elements are kept densely packed for iteration, and removals move
+// the last element into the hole. The elements, the slot of every element,
+// and the slots are in one allocation, so it can grow in place
+typedef struct {
+    mg_arena* _arena;
+    mga_u32 _elem_size;
+    mga_u32 _count;
+    mga_u32 _capacity;
+    mga_u32 _num_slots;
+    mga_u32 _free_slot;
+
+    mga_u8* _data;
+    mga_u32* _elem_slots;
+    _mga_slot* _slots;
+} mga_slot_map;
+
+MGA_FUNC_DEF mga_slot_map* mga_slot_map_create(mg_arena* arena, mga_u32 elem_size, mga_u32 capacity);
+
+// Copies elem into the map, or zeros the new element if elem is NULL.
+// Returns the zero handle on failure
+MGA_FUNC_DEF mga_slot_handle mga_slot_map_insert(mga_slot_map* map, const void* elem);
+// Returns NULL if the handle is no longer valid.
+// The pointer is invalidated by the next insert or remove
+MGA_FUNC_DEF void* mga_slot_map_get(mga_slot_map* map, mga_slot_handle handle);
+MGA_FUNC_DEF mga_b32 mga_slot_map_remove(mga_slot_map* map, mga_slot_handle handle);
+MGA_FUNC_DEF void mga_slot_map_clear(mga_slot_map* map);
+
+MGA_FUNC_DEF mga_u32 mga_slot_map_count(mga_slot_map* map);
+// Elements 0 to count - 1, in no particular order
+MGA_FUNC_DEF void* mga_slot_map_data(mga_slot_map* map);
+MGA_FUNC_DEF mga_slot_handle mga_slot_map_handle_at(mga_slot_map* map, mga_u32 index);
+
+#define MGA_SLOT_MAP_CREATE(arena, type, capacity) mga_slot_map_create(arena, sizeof(type), capacity)
+#define MGA_SLOT_MAP_GET(map, type, handle) (type*)mga_slot_map_get(map, handle)
+#define MGA_SLOT_MAP_DATA(map, type) (type*)mga_slot_map_data(map)
+
+// Fixed size chunks of elements, which are never moved after a push
+typedef struct mga_bucket {
+    struct mga_bucket* next;
+    mga_u32 count;
+    mga_u8* data;
+} mga_bucket;
+
+typedef struct {
+    mg_arena* _arena;
+    mga_u32 _elem_size;
+    mga_u32 _bucket_capacity;
+    mga_u64 _count;
+
+    mga_bucket* _first;
+    mga_bucket* _last;
+} mga_bucket_array;
+
+MGA_FUNC_DEF mga_bucket_array* mga_bucket_array_create(mg_arena* arena, mga_u32 elem_size, mga_u32 bucket_capacity);
+
+// Copies elem into the array, or zeros the new element if elem is NULL.
+// Returns NULL on failure
+MGA_FUNC_DEF void* mga_bucket_array_push(mga_bucket_array* arr, const void* elem);
+MGA_FUNC_DEF mga_u64 mga_bucket_array_count(mga_bucket_array* arr);
+
+// Iterate with:
+// for (mga_bucket* b = mga_bucket_array_first(arr); b != NULL; b = mga_bucket_next(b))
+MGA_FUNC_DEF mga_bucket* mga_bucket_array_first(mga_bucket_array* arr);
+// Also prefetches the start of the bucket after the next one
+MGA_FUNC_DEF mga_bucket* mga_bucket_next(mga_bucket* bucket);
+
+#define MGA_BUCKET_ARRAY_CREATE(arena, type, bucket_capacity) mga_bucket_array_create(arena, sizeof(type), bucket_capacity)
+#define MGA_BUCKET_ARRAY_PUSH(arr, type, elem) (type*)mga_bucket_array_push(arr, elem)
+
+// Same layout as mgp_string8
+typedef struct {
+    mga_u64 size;
+    mga_u8* str;
+} mga_str8;
+
+#ifdef __cplusplus
+#   define MGA_STR8(s) (mga_str8{ sizeof(s)-1, (mga_u8*)(s) })
+#else
+#   define MGA_STR8(s) ((mga_str8){ sizeof(s)-1, (mga_u8*)(s) })
+#endif
+
+MGA_FUNC_DEF mga_str8 mga_str8_from_cstr(const char* cstr);
+MGA_FUNC_DEF mga_b32 mga_str8_equal(mga_str8 a, mga_str8 b);
+MGA_FUNC_DEF mga_u64 mga_str8_hash(mga_str8 str);
+
+// Builds a string at the end of an arena. Appends grow the string in place,
+// so nothing is copied unless something else is pushed onto the arena before the string ends
+typedef struct {
+    mg_arena* _arena;
+    mga_u8* _str;
+    mga_u64 _size;
+} mga_str8_builder;
+
+MGA_FUNC_DEF mga_str8_builder mga_str8_builder_begin(mg_arena* arena);
+// The string is not null terminated
+MGA_FUNC_DEF mga_str8 mga_str8_builder_end(mga_str8_builder* builder);
+
+MGA_FUNC_DEF mga_b32 mga_str8_append(mga_str8_builder* builder, mga_str8 str);
+MGA_FUNC_DEF mga_b32 mga_str8_append_u64(mga_str8_builder* builder, mga_u64 value);
+MGA_FUNC_DEF mga_b32 mga_str8_append_i64(mga_str8_builder* builder, mga_i64 value);
+#ifndef MGA_NO_STDIO
+// Formats directly into the arena, like snprintf
+MGA_FUNC_DEF mga_b32 mga_str8_appendf(mga_str8_builder* builder, const char* fmt, ...);
+#endif
+
+// Interned strings are never moved, so equal strings
+// from the same table can be compared by pointer
+typedef struct {
+    mga_str8 str;
+    mga_u64 hash;
+} mga_interned;
+
+typedef struct {
+    mg_arena* _arena;
+    // Open addressing with linear probing, the capacity is a power of 2
+    mga_interned** _slots;
+    mga_u32 _capacity;
+    mga_u32 _count;
+} mga_intern_table;
+
+MGA_FUNC_DEF mga_intern_table* mga_intern_table_create(mg_arena* arena, mga_u32 capacity);
+// Returns the interned copy of str, or NULL on failure
+MGA_FUNC_DEF const mga_interned* mga_intern(mga_intern_table* table, mga_str8 str);
+// Returns NULL if str was never interned
+MGA_FUNC_DEF const mga_interned* mga_intern_find(mga_intern_table* table, mga_str8 str);
+MGA_FUNC_DEF mga_u32 mga_intern_table_count(mga_intern_table* table);
+
+// Reads a whole file straight into memory pushed onto arena.
+// str is NULL on failure
+MGA_FUNC_DEF mga_str8 mga_read_file(mg_arena* arena, const char* path);
+
+// Return false to stop reading
+typedef mga_b32 (mga_file_chunk_func)(void* user_data, const mga_u8* data, mga_u64 size);
+
+// Reads a file chunk_size bytes at a time into one buffer on arena,
+// which is popped when the file is done
+MGA_FUNC_DEF mga_b32 mga_read_file_chunks(mg_arena* arena, const char* path, mga_u64 chunk_size, mga_file_chunk_func* func, void* user_data);
+
+// Read only mapping of a file, nothing is copied
+typedef struct {
+    mga_u64 size;
+    const mga_u8* data;
+    void* _handle;
+} mga_file_view;
+
+MGA_FUNC_DEF mga_file_view mga_file_view_open(const char* path);
+MGA_FUNC_DEF void mga_file_view_close(mga_file_view* view);
+
+// Offset from the address of the mga_rel_ptr itself to the target, 0 is NULL.
+// Data that only points to itself with relative pointers can be moved,
+// saved, and loaded without fixing up any pointers
+typedef mga_i64 mga_rel_ptr;
+
+MGA_INLINE void mga_rel_set(mga_rel_ptr* rel, const void* ptr) {
+    *rel = ptr == (void*)0 ? 0 : (mga_i64)((intptr_t)ptr - (intptr_t)rel);
+}
+MGA_INLINE void* mga_rel_get(const mga_rel_ptr* rel) {
+    return *rel == 0 ? (void*)0 : (void*)((intptr_t)rel + (intptr_t)*rel);
+}
+
+#define MGA_REL_SET(rel, ptr) mga_rel_set(&(rel), (ptr))
+#define MGA_REL_GET(type, rel) ((type*)mga_rel_get(&(rel)))
+
+// Writes everything pushed onto arena (not including top allocations) to path.
+// The memory has to be contiguous, so malloc backend arenas only work within the first node
+MGA_FUNC_DEF mga_b32 mga_save(mg_arena* arena, const char* path);
+// Pushes the data written by mga_save onto arena, with the same offset from
+// a cache line that it had when it was saved. Returns NULL on failure
+MGA_FUNC_DEF void* mga_load(mg_arena* arena, const char* path, mga_u64* size);
+
+typedef struct {
+    // Nanoseconds since the timeline was created
+    mga_u64 time;
+    mga_u64 pos;
+    mga_u64 committed;
+} mga_sample;
+
+// Records the usage of an arena over time
+struct mga_timeline {
+    mga_str8 name;
+    // Bucket array of mga_sample
+    mga_bucket_array* samples;
+
+    mg_arena* _arena;
+    mga_u64 _start_time;
+};
+
+// The timeline is stored on storage, which cannot be the recorded arena.
+// Samples are taken on every commit and decommit of arena, and by mga_timeline_sample
+MGA_FUNC_DEF mga_timeline* mga_timeline_create(mg_arena* storage, mg_arena* arena, mga_str8 name);
+MGA_FUNC_DEF void mga_timeline_sample(mga_timeline* timeline);
+// Stops recording, this has to be called before the arena is destroyed
+MGA_FUNC_DEF void mga_timeline_stop(mga_timeline* timeline);
+
+// Stable LSD radix sorts, 8 bits per pass. values can be NULL,
+// otherwise it is reordered along with keys.
+// The temporary buffers come from mga_scratch_get.
+// Returns false if the scratch arena ran out of memory
+MGA_FUNC_DEF mga_b32 mga_radix_sort_u32(mga_u32* keys, mga_u32* values, mga_u64 count);
+MGA_FUNC_DEF mga_b32 mga_radix_sort_i32(mga_i32* keys, mga_u32* values, mga_u64 count);
+// Negative zero is sorted before zero, and NaNs are sorted to the ends by their sign
+MGA_FUNC_DEF mga_b32 mga_radix_sort_f32(float* keys, mga_u32* values, mga_u64 count);
+
+// Inclusive prefix sums, in place
+MGA_FUNC_DEF void mga_prefix_sum_u32(mga_u32* data, mga_u64 count);
+MGA_FUNC_DEF void mga_prefix_sum_f32(float* data, mga_u64 count);
 
 #ifdef __cplusplus
 }
@@ -172,12 +604,13 @@ extern "C" {
 #    error "MG ARENA: Must define all or none of, MGA_MEM_RESERVE, MGA_MEM_COMMIT, MGA_MEM_DECOMMIT, MGA_MEM_RELEASE, and MGA_MEM_PAGESIZE"
 #endif
 
-#if !defined(MGA_MEM_RESERVE) && !defined(MGA_FORCE_MALLOC) && (defined(MGA_PLATFORM_LINUX) || defined(MGA_PLATFORM_WIN32))
+#if !defined(MGA_MEM_RESERVE) && (defined(MGA_PLATFORM_LINUX) || defined(MGA_PLATFORM_WIN32))
 #    define MGA_MEM_RESERVE _mga_mem_reserve
 #    define MGA_MEM_COMMIT _mga_mem_commit
 #    define MGA_MEM_DECOMMIT _mga_mem_decommit
 #    define MGA_MEM_RELEASE _mga_mem_release
 #    define MGA_MEM_PAGESIZE _mga_mem_pagesize
+#    define _MGA_PLATFORM_MEM
 #endif
 
 // This is needed for the size and block_size calculations
@@ -185,21 +618,37 @@ extern "C" {
 #    define MGA_MEM_PAGESIZE _mga_mem_pagesize
 #endif
 
+// MGA_FORCE_MALLOC only changes what MGA_BACKEND_DEFAULT means,
+// every arena can still pick its own backend
 #if !defined(MGA_MEM_RESERVE) && !defined(MGA_FORCE_MALLOC)
 #   define MGA_FORCE_MALLOC
 #endif
 
-#if defined(MGA_FORCE_MALLOC)
-#    if defined(MGA_MALLOC) && defined(MGA_FREE)
-#    elif !defined(MGA_MALLOC) && !defined(MGA_FREE)
-#    else
-#        error "MGA ARENA: Must define both or none of MGA_MALLOC and MGA_FREE"
-#    endif
-#    ifndef MGA_MALLOC
-#        include <stdlib.h>
-#        define MGA_MALLOC malloc
-#        define MGA_FREE free
-#    endif
+// The malloc backend is always available, for buffer arenas and
+// arenas in the same program that use the low level backend
+#if defined(MGA_MALLOC) && defined(MGA_FREE)
+#elif !defined(MGA_MALLOC) && !defined(MGA_FREE)
+#    include <stdlib.h>
+#    define MGA_MALLOC malloc
+#    define MGA_FREE free
+#else
+#    error "MGA ARENA: Must define both or none of MGA_MALLOC and MGA_FREE"
+#endif
+
+#ifndef MGA_CACHE_COLORS
+#   define MGA_CACHE_COLORS 64
+#endif
+
+#ifndef MGA_MALLOC_NODE_CACHE
+#   define MGA_MALLOC_NODE_CACHE 4
+#endif
+
+#ifndef MGA_IO_URING_DEPTH
+#   define MGA_IO_URING_DEPTH 8
+#endif
+
+#ifndef MGA_IO_URING_CHUNK
+#   define MGA_IO_URING_CHUNK MGA_MiB(1)
 #endif
 
 #ifndef MGA_MEMSET
@@ -207,8 +656,39 @@ extern "C" {
 #   define MGA_MEMSET memset
 #endif
 
+#ifndef MGA_MEMCPY
+#   include <string.h>
+#   define MGA_MEMCPY memcpy
+#endif
+
+#ifndef MGA_MEMMOVE
+#   include <string.h>
+#   define MGA_MEMMOVE memmove
+#endif
+
+#ifndef MGA_MEMCMP
+#   include <string.h>
+#   define MGA_MEMCMP memcmp
+#endif
+
+#if !defined(MGA_NO_SIMD) && (defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+#   include <emmintrin.h>
+#   define MGA_SSE2
+#endif
+
+#ifndef MGA_PREFETCH
+#   if defined(__GNUC__) || defined(__clang__)
+#       define MGA_PREFETCH(ptr) __builtin_prefetch(ptr)
+#   elif defined(MGA_SSE2)
+#       define MGA_PREFETCH(ptr) _mm_prefetch((const char*)(ptr), _MM_HINT_T0)
+#   else
+#       define MGA_PREFETCH(ptr) ((void)(ptr))
+#   endif
+#endif
+
 #ifndef MGA_NO_STDIO
 #   include <stdio.h>
+#   include <stdarg.h>
 #endif
 
 #define MGA_UNUSED(x) (void)(x)
@@ -216,6 +696,24 @@ extern "C" {
 #define MGA_TRUE 1
 #define MGA_FALSE 0
 
+// The implementation avoids designated initializers and compound literals, so it compiles as C++11.
+// { 0 } warns about missing initializers in C++, and {} is not C before C23
+#ifdef __cplusplus
+#   define MGA_ZERO_INIT {}
+#else
+#   define MGA_ZERO_INIT { 0 }
+#endif
+
+#if defined(__cplusplus)
+#   define MGA_ALIGNOF(type) alignof(type)
+#elif defined(__STDC_VERSION__) && __STDC_VERSION__ >= 201112L
+#   define MGA_ALIGNOF(type) _Alignof(type)
+#elif defined(_MSC_VER)
+#   define MGA_ALIGNOF(type) __alignof(type)
+#else
+#   define MGA_ALIGNOF(type) __alignof__(type)
+#endif
+
 #ifndef MGA_THREAD_VAR
 #    if defined(__clang__) || defined(__GNUC__)
 #        define MGA_THREAD_VAR __thread
@@ -228,10 +726,22 @@ extern "C" {
 #    endif
 #endif
 
+#if defined(_MSC_VER) && !defined(__clang__)
+#    include <intrin.h>
+#    define MGA_ATOMIC_LOAD_ACQUIRE(p) ((mga_u64)_InterlockedOr64((volatile __int64*)(p), 0))
+#    define MGA_ATOMIC_STORE_RELEASE(p, v) _InterlockedExchange64((volatile __int64*)(p), (__int64)(v))
+#    define MGA_ATOMIC_FETCH_ADD_U32(p, v) ((mga_u32)_InterlockedExchangeAdd((volatile long*)(p), (long)(v)))
+#else
+#    define MGA_ATOMIC_LOAD_ACQUIRE(p) __atomic_load_n((p), __ATOMIC_ACQUIRE)
+#    define MGA_ATOMIC_STORE_RELEASE(p, v) __atomic_store_n((p), (v), __ATOMIC_RELEASE)
+#    define MGA_ATOMIC_FETCH_ADD_U32(p, v) __atomic_fetch_add((p), (v), __ATOMIC_RELAXED)
+#endif
+
 #define MGA_MIN(a, b) ((a) < (b) ? (a) : (b))
 #define MGA_MAX(a, b) ((a) > (b) ? (a) : (b))
 
 #define MGA_ALIGN_UP_POW2(x, b) (((mga_u64)(x) + ((mga_u64)(b) - 1)) & (~((mga_u64)(b) - 1)))
+#define MGA_ALIGN_DOWN_POW2(x, b) ((mga_u64)(x) & (~((mga_u64)(b) - 1)))
 
 #ifdef MGA_PLATFORM_WIN32
 
@@ -242,7 +752,7 @@ extern "C" {
 
 #include <Windows.h>
 
-#ifndef MGA_FORCE_MALLOC
+#ifdef _MGA_PLATFORM_MEM
 static void* _mga_mem_reserve(mga_u64 size) {
     void* out = VirtualAlloc(0, size, MEM_RESERVE, PAGE_READWRITE);
     return out;
@@ -265,6 +775,143 @@ static mga_u32 _mga_mem_pagesize() {
     return (mga_u32)si.dwPageSize;
 }
 
+static mga_u64 _mga_ring_granularity(void) {
+    SYSTEM_INFO si;
+    GetSystemInfo(&si);
+    return (mga_u64)si.dwAllocationGranularity;
+}
+// Maps header_size bytes of private memory, followed by two views of the same size bytes
+static void* _mga_ring_map(mga_u64 header_size, mga_u64 size, void** handle) {
+    HANDLE mapping = CreateFileMapping(
+        INVALID_HANDLE_VALUE, NULL, PAGE_READWRITE,
+        (DWORD)(size >> 32), (DWORD)(size & 0xffffffff), NULL
+    );
+    if (mapping == NULL) {
+        return NULL;
+    }
+
+    // Another thread can take the address range between freeing and mapping it,
+    // so this has to be attempted a few times
+    for (mga_u32 attempt = 0; attempt < 16; attempt++) {
+        mga_u8* base = (mga_u8*)VirtualAlloc(NULL, header_size + size * 2, MEM_RESERVE, PAGE_NOACCESS);
+        if (base == NULL) {
+            break;
+        }
+        VirtualFree(base, 0, MEM_RELEASE);
+
+        void* header = VirtualAlloc(base, header_size, MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE);
+        void* view0 = header == NULL ? NULL :
+            MapViewOfFileEx(mapping, FILE_MAP_ALL_ACCESS, 0, 0, size, base + header_size);
+        void* view1 = view0 == NULL ? NULL :
+            MapViewOfFileEx(mapping, FILE_MAP_ALL_ACCESS, 0, 0, size, base + header_size + size);
+
+        if (view1 != NULL) {
+            *handle = (void*)mapping;
+            return (void*)base;
+        }
+
+        if (view0 != NULL) { UnmapViewOfFile(view0); }
+        if (header != NULL) { VirtualFree(header, 0, MEM_RELEASE); }
+    }
+
+    CloseHandle(mapping);
+    return NULL;
+}
+static void _mga_ring_unmap(void* ptr, mga_u64 header_size, mga_u64 size, void* handle) {
+    mga_u8* base = (mga_u8*)ptr;
+    UnmapViewOfFile(base + header_size + size);
+    UnmapViewOfFile(base + header_size);
+    VirtualFree(base, 0, MEM_RELEASE);
+    CloseHandle((HANDLE)handle);
+}
+
+// Returns -1 on failure
+static mga_i64 _mga_file_open(const char* path, mga_u64* size) {
+    HANDLE file = CreateFileA(
+        path, GENERIC_READ, FILE_SHARE_READ, NULL,
+        OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, NULL
+    );
+    if (file == INVALID_HANDLE_VALUE) {
+        return -1;
+    }
+
+    LARGE_INTEGER file_size;
+    if (!GetFileSizeEx(file, &file_size)) {
+        CloseHandle(file);
+        return -1;
+    }
+
+    *size = (mga_u64)file_size.QuadPart;
+    return (mga_i64)(intptr_t)file;
+}
+// Returns the number of bytes read, 0 at the end of the file, or -1 on failure
+static mga_i64 _mga_file_read(mga_i64 file, void* buffer, mga_u64 size, mga_u64 offset) {
+    OVERLAPPED overlapped = MGA_ZERO_INIT;
+    overlapped.Offset = (DWORD)(offset & 0xffffffff);
+    overlapped.OffsetHigh = (DWORD)(offset >> 32);
+
+    DWORD bytes_read = 0;
+    if (!ReadFile((HANDLE)(intptr_t)file, buffer, (DWORD)MGA_MIN(size, MGA_GiB(1)), &bytes_read, &overlapped)) {
+        return GetLastError() == ERROR_HANDLE_EOF ? 0 : -1;
+    }
+
+    return (mga_i64)bytes_read;
+}
+static void _mga_file_close(mga_i64 file) {
+    CloseHandle((HANDLE)(intptr_t)file);
+}
+// Creates or truncates the file, returns -1 on failure
+static mga_i64 _mga_file_create(const char* path) {
+    HANDLE file = CreateFileA(
+        path, GENERIC_WRITE, 0, NULL,
+        CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, NULL
+    );
+
+    return file == INVALID_HANDLE_VALUE ? -1 : (mga_i64)(intptr_t)file;
+}
+// Returns the number of bytes written, or -1 on failure
+static mga_i64 _mga_file_write(mga_i64 file, const void* buffer, mga_u64 size) {
+    DWORD bytes_written = 0;
+    if (!WriteFile((HANDLE)(intptr_t)file, buffer, (DWORD)MGA_MIN(size, MGA_GiB(1)), &bytes_written, NULL)) {
+        return -1;
+    }
+
+    return (mga_i64)bytes_written;
+}
+static void* _mga_file_map(mga_i64 file, mga_u64 size, void** handle) {
+    MGA_UNUSED(size);
+
+    HANDLE mapping = CreateFileMapping((HANDLE)(intptr_t)file, NULL, PAGE_READONLY, 0, 0, NULL);
+    if (mapping == NULL) {
+        return NULL;
+    }
+
+    void* out = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    if (out == NULL) {
+        CloseHandle(mapping);
+        return NULL;
+    }
+
+    *handle = (void*)mapping;
+    return out;
+}
+static void _mga_file_unmap(void* ptr, mga_u64 size, void* handle) {
+    MGA_UNUSED(size);
+    UnmapViewOfFile(ptr);
+    CloseHandle((HANDLE)handle);
+}
+
+static mga_u64 _mga_time_ns(void) {
+    LARGE_INTEGER freq, counter;
+    QueryPerformanceFrequency(&freq);
+    QueryPerformanceCounter(&counter);
+
+    // Split up so the multiplication does not overflow
+    mga_u64 secs = (mga_u64)counter.QuadPart / (mga_u64)freq.QuadPart;
+    mga_u64 rem = (mga_u64)counter.QuadPart % (mga_u64)freq.QuadPart;
+    return secs * 1000000000ull + rem * 1000000000ull / (mga_u64)freq.QuadPart;
+}
+
 #endif // MGA_PLATFORM_WIN32
 
 #if defined(MGA_PLATFORM_LINUX) || defined(MGA_PLATFORM_APPLE)
@@ -272,7 +919,7 @@ static mga_u32 _mga_mem_pagesize() {
 #include <sys/mman.h>
 #include <unistd.h>
 
-#ifndef MGA_FORCE_MALLOC
+#ifdef _MGA_PLATFORM_MEM
 static void* _mga_mem_reserve(mga_u64 size) {
     void* out = mmap(NULL, size, PROT_NONE, MAP_SHARED | MAP_ANONYMOUS, -1, (off_t)0);
     return out;
@@ -293,72 +940,516 @@ static mga_u32 _mga_mem_pagesize() {
     return (mga_u32)sysconf(_SC_PAGESIZE);
 }
 
-#endif // MGA_PLATFORM_LINUX || MGA_PLATFORM_APPLE
+#include <errno.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#ifdef MGA_PLATFORM_LINUX
+#    include <sys/syscall.h>
+#endif
 
-#ifdef MGA_PLATFORM_UNKNOWN
+static mga_u64 _mga_ring_granularity(void) {
+    return (mga_u64)sysconf(_SC_PAGESIZE);
+}
+static int _mga_ring_open_fd(mga_u64 size) {
+    int fd = -1;
 
-#ifndef MGA_FORCE_MALLOC
-static void* _mga_mem_reserve(mga_u64 size) { MGA_UNUSED(size); return NULL; }
-static void _mga_mem_commit(void* ptr, mga_u64 size) { MGA_UNUSED(ptr); MGA_UNUSED(size); }
-static void _mga_mem_decommit(void* ptr, mga_u64 size) { MGA_UNUSED(ptr); MGA_UNUSED(size); }
-static void _mga_mem_release(void* ptr, mga_u64 size) { MGA_UNUSED(ptr); MGA_UNUSED(size); }
+#if defined(MGA_PLATFORM_LINUX) && defined(SYS_memfd_create)
+    fd = (int)syscall(SYS_memfd_create, "mga_ring", 0);
 #endif
-static mga_u32 _mga_mem_pagesize(){ return 4096; }
 
-#endif // MGA_PLATFORM_UNKNOWN
+    // Fallback to an unlinked shared memory object
+    // The counter is shared by every thread, so names are unique within the process.
+    // A name can still exist if another process with the same pid crashed, so that is retried
+    static mga_u32 counter = 0;
+    for (mga_u32 attempt = 0; fd == -1 && attempt < 16; attempt++) {
+        // "/mga_ring_<pid>_<counter>"
+        char name[64] = "/mga_ring_";
+        mga_u32 len = 10;
+        mga_u64 parts[2] = { (mga_u64)getpid(), MGA_ATOMIC_FETCH_ADD_U32(&counter, 1) };
+        for (mga_u32 i = 0; i < 2; i++) {
+            char digits[20];
+            mga_u32 num_digits = 0;
+            do {
+                digits[num_digits++] = (char)('0' + parts[i] % 10);
+                parts[i] /= 10;
+            } while (parts[i] != 0);
+
+            while (num_digits > 0) {
+                name[len++] = digits[--num_digits];
+            }
+            name[len++] = i == 0 ? '_' : '\0';
+        }
 
-// https://graphics.stanford.edu/~seander/bithacks.html#RoundUpPowerOf2
-static mga_u32 _mga_round_pow2(mga_u32 v) {
-    v--;
-    v |= v >> 1;
-    v |= v >> 2;
-    v |= v >> 4;
-    v |= v >> 8;
-    v |= v >> 16;
-    v++;
-    
-    return v;
+        fd = shm_open(name, O_RDWR | O_CREAT | O_EXCL, S_IRUSR | S_IWUSR);
+        if (fd != -1) {
+            shm_unlink(name);
+        } else if (errno != EEXIST) {
+            return -1;
+        }
+    }
+
+    if (fd == -1) {
+        return -1;
+    }
+
+    if (ftruncate(fd, (off_t)size) != 0) {
+        close(fd);
+        return -1;
+    }
+
+    return fd;
 }
+// Maps header_size bytes of private memory, followed by two views of the same size bytes
+static void* _mga_ring_map(mga_u64 header_size, mga_u64 size, void** handle) {
+    MGA_UNUSED(handle);
 
+    int fd = _mga_ring_open_fd(size);
+    if (fd == -1) {
+        return NULL;
+    }
 
-typedef struct {
-    mga_error_callback* error_callback;
-    mga_u64 max_size;
-    mga_u32 block_size;
-    mga_u32 align;
-} _mga_init_data;
+    mga_u64 total_size = header_size + size * 2;
+    mga_u8* base = (mga_u8*)mmap(NULL, total_size, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS, -1, (off_t)0);
+    if (base == MAP_FAILED) {
+        close(fd);
+        return NULL;
+    }
 
-static void _mga_empty_error_callback(mga_error error) {
-    MGA_UNUSED(error);
+    void* header = mmap(base, header_size, PROT_READ | PROT_WRITE, MAP_FIXED | MAP_PRIVATE | MAP_ANONYMOUS, -1, (off_t)0);
+    void* view0 = mmap(base + header_size, size, PROT_READ | PROT_WRITE, MAP_FIXED | MAP_SHARED, fd, (off_t)0);
+    void* view1 = mmap(base + header_size + size, size, PROT_READ | PROT_WRITE, MAP_FIXED | MAP_SHARED, fd, (off_t)0);
+
+    // The mappings keep the memory alive
+    close(fd);
+
+    if (header == MAP_FAILED || view0 == MAP_FAILED || view1 == MAP_FAILED) {
+        munmap(base, total_size);
+        return NULL;
+    }
+
+    return (void*)base;
+}
+static void _mga_ring_unmap(void* ptr, mga_u64 header_size, mga_u64 size, void* handle) {
+    MGA_UNUSED(handle);
+    munmap(ptr, header_size + size * 2);
 }
 
-static _mga_init_data _mga_init_common(const mga_desc* desc) {
-    _mga_init_data out = { 0 };
-    
-    out.error_callback = desc->error_callback == NULL ?
-        _mga_empty_error_callback : desc->error_callback;
+// Returns -1 on failure
+static mga_i64 _mga_file_open(const char* path, mga_u64* size) {
+    int fd = open(path, O_RDONLY | O_CLOEXEC);
+    if (fd == -1) {
+        return -1;
+    }
 
-    mga_u32 page_size = MGA_MEM_PAGESIZE();
-    
-    out.max_size = MGA_ALIGN_UP_POW2(desc->desired_max_size, page_size);
-    mga_u32 desired_block_size = desc->desired_block_size == 0 ? 
-        MGA_ALIGN_UP_POW2(out.max_size / 8, page_size) : desc->desired_block_size;
-    desired_block_size = MGA_ALIGN_UP_POW2(desired_block_size, page_size);
-    
-    out.block_size = _mga_round_pow2(desired_block_size);
-    
-    out.align = desc->align == 0 ? (sizeof(void*)) : desc->align;
-    
-    return out;
+    struct stat st;
+    if (fstat(fd, &st) != 0 || !S_ISREG(st.st_mode)) {
+        close(fd);
+        return -1;
+    }
+
+#ifdef MGA_PLATFORM_LINUX
+    // Doubles the readahead window
+    posix_fadvise(fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+#endif
+
+    *size = (mga_u64)st.st_size;
+    return (mga_i64)fd;
 }
+// Returns the number of bytes read, 0 at the end of the file, or -1 on failure
+static mga_i64 _mga_file_read(mga_i64 file, void* buffer, mga_u64 size, mga_u64 offset) {
+    // Linux reads at most 0x7ffff000 bytes at a time
+    size = MGA_MIN(size, MGA_GiB(1));
 
-// This is an annoying placement, but
-// it has to be above the implementations that reference it
-static MGA_THREAD_VAR mga_error last_error;
+    ssize_t bytes_read = 0;
+    do {
+        bytes_read = pread((int)file, buffer, (size_t)size, (off_t)offset);
+    } while (bytes_read == -1 && errno == EINTR);
 
-#ifdef MGA_FORCE_MALLOC
+    return (mga_i64)bytes_read;
+}
+static void _mga_file_close(mga_i64 file) {
+    close((int)file);
+}
 
-/*
+#if defined(MGA_PLATFORM_LINUX) && defined(SYS_io_uring_setup) && !defined(MGA_NO_IO_URING) && defined(__has_include)
+#    if __has_include(<linux/io_uring.h>)
+#        define _MGA_IO_URING
+#    endif
+#endif
+
+#ifdef _MGA_IO_URING
+
+#include <linux/io_uring.h>
+
+// Only the parts of io_uring that are needed for reads, with the raw syscalls,
+// so there is no dependency on liburing
+typedef struct {
+    int fd;
+    mga_u32 sq_entries;
+
+    void* sq_ptr;
+    mga_u64 sq_size;
+    void* cq_ptr;
+    mga_u64 cq_size;
+    struct io_uring_sqe* sqes;
+    mga_u64 sqes_size;
+
+    mga_u32* sq_tail;
+    mga_u32* sq_mask;
+    mga_u32* sq_array;
+    mga_u32* cq_head;
+    mga_u32* cq_tail;
+    mga_u32* cq_mask;
+    struct io_uring_cqe* cqes;
+} _mga_uring;
+
+static void _mga_uring_destroy(_mga_uring* ring) {
+    if (ring->sqes != MAP_FAILED) {
+        munmap(ring->sqes, ring->sqes_size);
+    }
+    if (ring->cq_ptr != MAP_FAILED && ring->cq_ptr != ring->sq_ptr) {
+        munmap(ring->cq_ptr, ring->cq_size);
+    }
+    if (ring->sq_ptr != MAP_FAILED) {
+        munmap(ring->sq_ptr, ring->sq_size);
+    }
+
+    close(ring->fd);
+}
+static mga_b32 _mga_uring_init(_mga_uring* ring, mga_u32 entries) {
+    struct io_uring_params params;
+    MGA_MEMSET(&params, 0, sizeof(params));
+
+    int fd = (int)syscall(SYS_io_uring_setup, entries, &params);
+    if (fd < 0) {
+        return MGA_FALSE;
+    }
+
+    ring->fd = fd;
+    ring->sq_entries = params.sq_entries;
+    ring->sq_size = params.sq_off.array + params.sq_entries * sizeof(mga_u32);
+    ring->cq_size = params.cq_off.cqes + params.cq_entries * sizeof(struct io_uring_cqe);
+    ring->sqes_size = params.sq_entries * sizeof(struct io_uring_sqe);
+
+    // Both rings share one mapping on newer kernels
+    mga_b32 single_mmap = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+    if (single_mmap) {
+        ring->sq_size = MGA_MAX(ring->sq_size, ring->cq_size);
+        ring->cq_size = ring->sq_size;
+    }
+
+    ring->sq_ptr = mmap(NULL, ring->sq_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, (off_t)IORING_OFF_SQ_RING);
+    ring->cq_ptr = single_mmap ? ring->sq_ptr :
+        mmap(NULL, ring->cq_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, (off_t)IORING_OFF_CQ_RING);
+    ring->sqes = (struct io_uring_sqe*)mmap(NULL, ring->sqes_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, (off_t)IORING_OFF_SQES);
+
+    if (ring->sq_ptr == MAP_FAILED || ring->cq_ptr == MAP_FAILED || ring->sqes == MAP_FAILED) {
+        _mga_uring_destroy(ring);
+        return MGA_FALSE;
+    }
+
+    mga_u8* sq = (mga_u8*)ring->sq_ptr;
+    mga_u8* cq = (mga_u8*)ring->cq_ptr;
+    ring->sq_tail = (mga_u32*)(sq + params.sq_off.tail);
+    ring->sq_mask = (mga_u32*)(sq + params.sq_off.ring_mask);
+    ring->sq_array = (mga_u32*)(sq + params.sq_off.array);
+    ring->cq_head = (mga_u32*)(cq + params.cq_off.head);
+    ring->cq_tail = (mga_u32*)(cq + params.cq_off.tail);
+    ring->cq_mask = (mga_u32*)(cq + params.cq_off.ring_mask);
+    ring->cqes = (struct io_uring_cqe*)(cq + params.cq_off.cqes);
+
+    return MGA_TRUE;
+}
+// There has to be space in the submission queue.
+// The file offset is the user data of the completion
+static void _mga_uring_read(_mga_uring* ring, int fd, void* buffer, mga_u32 size, mga_u64 offset) {
+    // Only this thread writes the tail
+    mga_u32 tail = *ring->sq_tail;
+    mga_u32 index = tail & *ring->sq_mask;
+
+    struct io_uring_sqe* sqe = &ring->sqes[index];
+    MGA_MEMSET(sqe, 0, sizeof(*sqe));
+    sqe->opcode = IORING_OP_READ;
+    sqe->fd = fd;
+    sqe->addr = (mga_u64)(uintptr_t)buffer;
+    sqe->len = size;
+    sqe->off = offset;
+    sqe->user_data = offset;
+
+    ring->sq_array[index] = index;
+    MGA_ATOMIC_STORE_RELEASE(ring->sq_tail, tail + 1);
+}
+// Submits the queued reads and waits for at least one completion.
+// Returns the number of submitted reads, or -1 on failure
+static int _mga_uring_enter(_mga_uring* ring, mga_u32 to_submit) {
+    int ret = 0;
+    do {
+        ret = (int)syscall(SYS_io_uring_enter, ring->fd, to_submit, 1, IORING_ENTER_GETEVENTS, NULL, 0);
+    } while (ret < 0 && errno == EINTR);
+
+    return ret;
+}
+static mga_b32 _mga_uring_pop(_mga_uring* ring, mga_u64* offset, mga_i32* res) {
+    mga_u32 head = *ring->cq_head;
+    if (head == MGA_ATOMIC_LOAD_ACQUIRE(ring->cq_tail)) {
+        return MGA_FALSE;
+    }
+
+    struct io_uring_cqe* cqe = &ring->cqes[head & *ring->cq_mask];
+    *offset = cqe->user_data;
+    *res = cqe->res;
+
+    MGA_ATOMIC_STORE_RELEASE(ring->cq_head, head + 1);
+    return MGA_TRUE;
+}
+
+// Set when the kernel or a seccomp filter does not allow io_uring
+static mga_b32 _mga_uring_unavailable = MGA_FALSE;
+
+// Reads size bytes at file_offset with up to MGA_IO_URING_DEPTH reads in flight.
+// Returns the number of bytes read, which is less than size if the file got smaller,
+// or -1 if io_uring failed. Then the caller falls back to pread
+static mga_i64 _mga_file_read_async(mga_i64 file, mga_u8* buffer, mga_u64 size, mga_u64 file_offset) {
+    if (MGA_ATOMIC_LOAD_ACQUIRE(&_mga_uring_unavailable)) {
+        return -1;
+    }
+
+    _mga_uring ring;
+    if (!_mga_uring_init(&ring, MGA_IO_URING_DEPTH)) {
+        if (errno == ENOSYS || errno == EPERM) {
+            MGA_ATOMIC_STORE_RELEASE(&_mga_uring_unavailable, MGA_TRUE);
+        }
+        return -1;
+    }
+
+    const mga_u64 chunk_size = MGA_IO_URING_CHUNK;
+
+    // Offset of the next chunk, and where the file ended if it got smaller
+    mga_u64 next = 0;
+    mga_u64 end = size;
+    mga_u32 queued = 0;
+    mga_u32 in_flight = 0;
+    mga_b32 failed = MGA_FALSE;
+
+    for (;;) {
+        while (!failed && next < end && queued + in_flight < ring.sq_entries) {
+            mga_u64 chunk = MGA_MIN(chunk_size, end - next);
+            _mga_uring_read(&ring, (int)file, buffer + next, (mga_u32)chunk, file_offset + next);
+            next += chunk;
+            queued++;
+        }
+
+        if (queued + in_flight == 0) {
+            break;
+        }
+
+        int submitted = _mga_uring_enter(&ring, queued);
+        if (submitted < 0) {
+            failed = MGA_TRUE;
+
+            // Queued reads that were not submitted are dropped with the ring.
+            // The reads in flight still write to the buffer, so their completions
+            // are reaped until there are none left, even if entering keeps failing
+            queued = 0;
+            submitted = 0;
+        }
+
+        queued -= (mga_u32)submitted;
+        in_flight += (mga_u32)submitted;
+
+        mga_u64 offset = 0;
+        mga_i32 res = 0;
+        while (_mga_uring_pop(&ring, &offset, &res)) {
+            in_flight--;
+            offset -= file_offset;
+
+            // Errors include kernels without IORING_OP_READ, so pread gets the next try
+            if (res < 0) {
+                failed = MGA_TRUE;
+            } else if (res == 0) {
+                end = MGA_MIN(end, offset);
+            } else if (!failed) {
+                // Short reads continue where they stopped
+                mga_u64 chunk_end = MGA_MIN((offset / chunk_size + 1) * chunk_size, end);
+                mga_u64 read_end = offset + (mga_u64)res;
+                if (read_end < chunk_end) {
+                    _mga_uring_read(&ring, (int)file, buffer + read_end, (mga_u32)(chunk_end - read_end), file_offset + read_end);
+                    queued++;
+                }
+            }
+        }
+    }
+
+    _mga_uring_destroy(&ring);
+
+    return failed ? -1 : (mga_i64)end;
+}
+
+#endif // _MGA_IO_URING
+
+// Creates or truncates the file, returns -1 on failure
+static mga_i64 _mga_file_create(const char* path) {
+    int fd = -1;
+    do {
+        fd = open(path, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    } while (fd == -1 && errno == EINTR);
+
+    return (mga_i64)fd;
+}
+// Returns the number of bytes written, or -1 on failure.
+// Works with pipes too, since it does not seek
+static mga_i64 _mga_file_write(mga_i64 file, const void* buffer, mga_u64 size) {
+    size = MGA_MIN(size, MGA_GiB(1));
+
+    ssize_t bytes_written = 0;
+    do {
+        bytes_written = write((int)file, buffer, (size_t)size);
+    } while (bytes_written == -1 && errno == EINTR);
+
+    return (mga_i64)bytes_written;
+}
+static void* _mga_file_map(mga_i64 file, mga_u64 size, void** handle) {
+    MGA_UNUSED(handle);
+
+    void* out = mmap(NULL, size, PROT_READ, MAP_PRIVATE, (int)file, (off_t)0);
+    if (out == MAP_FAILED) {
+        return NULL;
+    }
+
+    madvise(out, size, MADV_SEQUENTIAL);
+    return out;
+}
+static void _mga_file_unmap(void* ptr, mga_u64 size, void* handle) {
+    MGA_UNUSED(handle);
+    munmap(ptr, size);
+}
+
+#include <time.h>
+
+static mga_u64 _mga_time_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (mga_u64)ts.tv_sec * 1000000000ull + (mga_u64)ts.tv_nsec;
+}
+
+#endif // MGA_PLATFORM_LINUX || MGA_PLATFORM_APPLE
+
+#ifdef MGA_PLATFORM_UNKNOWN
+
+#ifdef _MGA_PLATFORM_MEM
+static void* _mga_mem_reserve(mga_u64 size) { MGA_UNUSED(size); return NULL; }
+static void _mga_mem_commit(void* ptr, mga_u64 size) { MGA_UNUSED(ptr); MGA_UNUSED(size); }
+static void _mga_mem_decommit(void* ptr, mga_u64 size) { MGA_UNUSED(ptr); MGA_UNUSED(size); }
+static void _mga_mem_release(void* ptr, mga_u64 size) { MGA_UNUSED(ptr); MGA_UNUSED(size); }
+#endif
+static mga_u32 _mga_mem_pagesize(){ return 4096; }
+
+#endif // MGA_PLATFORM_UNKNOWN
+
+#if defined(MGA_PLATFORM_EMSCRIPTEN) || defined(MGA_PLATFORM_UNKNOWN)
+
+static mga_u64 _mga_ring_granularity(void) { return 4096; }
+static void* _mga_ring_map(mga_u64 header_size, mga_u64 size, void** handle) {
+    MGA_UNUSED(header_size); MGA_UNUSED(size); MGA_UNUSED(handle);
+    return NULL;
+}
+static void _mga_ring_unmap(void* ptr, mga_u64 header_size, mga_u64 size, void* handle) {
+    MGA_UNUSED(ptr); MGA_UNUSED(header_size); MGA_UNUSED(size); MGA_UNUSED(handle);
+}
+
+static mga_i64 _mga_file_open(const char* path, mga_u64* size) {
+    MGA_UNUSED(path); MGA_UNUSED(size);
+    return -1;
+}
+static mga_i64 _mga_file_read(mga_i64 file, void* buffer, mga_u64 size, mga_u64 offset) {
+    MGA_UNUSED(file); MGA_UNUSED(buffer); MGA_UNUSED(size); MGA_UNUSED(offset);
+    return -1;
+}
+static void _mga_file_close(mga_i64 file) { MGA_UNUSED(file); }
+static mga_i64 _mga_file_create(const char* path) {
+    MGA_UNUSED(path);
+    return -1;
+}
+static mga_i64 _mga_file_write(mga_i64 file, const void* buffer, mga_u64 size) {
+    MGA_UNUSED(file); MGA_UNUSED(buffer); MGA_UNUSED(size);
+    return -1;
+}
+static void* _mga_file_map(mga_i64 file, mga_u64 size, void** handle) {
+    MGA_UNUSED(file); MGA_UNUSED(size); MGA_UNUSED(handle);
+    return NULL;
+}
+static void _mga_file_unmap(void* ptr, mga_u64 size, void* handle) {
+    MGA_UNUSED(ptr); MGA_UNUSED(size); MGA_UNUSED(handle);
+}
+
+// Samples are still in order, but every sample has the same time
+static mga_u64 _mga_time_ns(void) { return 0; }
+
+#endif // MGA_PLATFORM_EMSCRIPTEN || MGA_PLATFORM_UNKNOWN
+
+// https://graphics.stanford.edu/~seander/bithacks.html#RoundUpPowerOf2
+static mga_u32 _mga_round_pow2(mga_u32 v) {
+    v--;
+    v |= v >> 1;
+    v |= v >> 2;
+    v |= v >> 4;
+    v |= v >> 8;
+    v |= v >> 16;
+    v++;
+    
+    return v;
+}
+
+
+typedef struct {
+    mga_error_callback* error_callback;
+    mga_u64 max_size;
+    mga_u32 block_size;
+    mga_u32 align;
+    // Added to the start position of the arena
+    mga_u64 color_offset;
+} _mga_init_data;
+
+static void _mga_empty_error_callback(mga_error error) {
+    MGA_UNUSED(error);
+}
+
+static mga_u32 _mga_next_color = 0;
+
+static _mga_init_data _mga_init_common(const mga_desc* desc) {
+    _mga_init_data out = MGA_ZERO_INIT;
+    
+    out.error_callback = desc->error_callback == NULL ?
+        _mga_empty_error_callback : desc->error_callback;
+
+    mga_u32 page_size = MGA_MEM_PAGESIZE();
+    
+    out.max_size = MGA_ALIGN_UP_POW2(desc->desired_max_size, page_size);
+    mga_u32 desired_block_size = desc->desired_block_size == 0 ? 
+        MGA_ALIGN_UP_POW2(out.max_size / 8, page_size) : desc->desired_block_size;
+    desired_block_size = MGA_ALIGN_UP_POW2(desired_block_size, page_size);
+    
+    out.block_size = _mga_round_pow2(desired_block_size);
+    
+    out.align = desc->align == 0 ? (sizeof(void*)) : desc->align;
+
+    if (desc->cache_color) {
+        mga_u32 color = MGA_ATOMIC_FETCH_ADD_U32(&_mga_next_color, 1) % MGA_CACHE_COLORS;
+        out.color_offset = (mga_u64)color * MGA_CACHE_LINE;
+    }
+    
+    return out;
+}
+
+// This is an annoying placement, but
+// it has to be above the implementations that reference it
+static MGA_THREAD_VAR mga_error last_error;
+
+#define _MGA_BACKEND_MALLOC 0
+#define _MGA_BACKEND_RESERVE 1
+#define _MGA_BACKEND_BUFFER 2
+
+/*
 Malloc Backend
 ======================================================================
   __  __   _   _    _    ___   ___   ___   _   ___ _  _____ _  _ ___  
@@ -369,343 +1460,2274 @@ Malloc Backend
 ======================================================================
 */
                                                                       
-mg_arena* mga_create(const mga_desc* desc) {
-    _mga_init_data init_data = _mga_init_common(desc);
 
-    mg_arena* out = (mg_arena*)malloc(sizeof(mg_arena));
+static void _mga_malloc_update_fast(mg_arena* arena) {
+    _mga_malloc_node* node = arena->_malloc_backend.cur_node;
+
+    arena->_fast_base = node->data - node->start;
+    arena->_fast_limit = MGA_MIN(node->start + node->size, arena->_size);
+}
+
+static _mga_malloc_node* _mga_malloc_node_create(mga_u64 start, mga_u64 size) {
+    _mga_malloc_node* node = (_mga_malloc_node*)MGA_MALLOC(sizeof(_mga_malloc_node) + size);
+
+    if (node == NULL) {
+        return NULL;
+    }
+
+    node->prev = NULL;
+    node->start = start;
+    node->size = size;
+    node->data = (mga_u8*)(node + 1);
+
+    return node;
+}
+
+// Takes the first cached node with at least min_size bytes
+static _mga_malloc_node* _mga_malloc_node_reuse(mg_arena* arena, mga_u64 start, mga_u64 min_size) {
+    _mga_malloc_node** link = &arena->_malloc_backend.free_nodes;
+
+    while (*link != NULL) {
+        _mga_malloc_node* node = *link;
+
+        if (node->size >= min_size) {
+            *link = node->prev;
+            arena->_malloc_backend.num_free_nodes--;
+
+            node->prev = NULL;
+            node->start = start;
+
+            return node;
+        }
+
+        link = &node->prev;
+    }
+
+    return NULL;
+}
+
+// Caching popped nodes means that pushing and popping
+// across a node boundary does not call malloc and free every time.
+// Nodes bigger than a block came from big pushes, so they are not kept
+static void _mga_malloc_node_release(mg_arena* arena, _mga_malloc_node* node) {
+    if (arena->_malloc_backend.num_free_nodes >= MGA_MALLOC_NODE_CACHE || node->size > arena->_block_size) {
+        MGA_FREE(node);
+        return;
+    }
+
+    node->prev = arena->_malloc_backend.free_nodes;
+    arena->_malloc_backend.free_nodes = node;
+    arena->_malloc_backend.num_free_nodes++;
+}
+
+static mg_arena* _mga_malloc_create(const _mga_init_data* init_data) {
+    mg_arena* out = (mg_arena*)MGA_MALLOC(sizeof(mg_arena));
+    _mga_malloc_node* node = _mga_malloc_node_create(0, MGA_MIN(init_data->block_size, init_data->max_size));
+
+    if (out == NULL || node == NULL) {
+        if (out != NULL) { MGA_FREE(out); }
 
-    if (out == NULL) {
         last_error.code = MGA_ERR_INIT_FAILED;
         last_error.msg = "Failed to malloc initial memory for arena";
-        init_data.error_callback(last_error);
+        init_data->error_callback(last_error);
         return NULL;
     }
     
-    out->_pos = 0;
-    out->_size = init_data.max_size;
-    out->_block_size = init_data.block_size;
-    out->_align = init_data.align;
-    out->_last_error = (mga_error){ .code=MGA_ERR_NONE, .msg="" };
-    out->error_callback = init_data.error_callback;
+    out->_pos = init_data->color_offset;
+    out->_start_pos = init_data->color_offset;
+    out->_backend = _MGA_BACKEND_MALLOC;
+    out->_size = init_data->max_size;
+    out->_block_size = init_data->block_size;
+    out->_align = init_data->align;
+    out->_last_error.code = MGA_ERR_NONE;
+    out->_last_error.msg = "";
+    out->error_callback = init_data->error_callback;
+
+    out->_malloc_backend.cur_node = node;
+    out->_malloc_backend.free_nodes = NULL;
+    out->_malloc_backend.num_free_nodes = 0;
+    out->_timeline = NULL;
+    _mga_malloc_update_fast(out);
+
+    return out;
+}
+static void _mga_malloc_free_list(_mga_malloc_node* node) {
+    while (node != NULL) {
+        _mga_malloc_node* temp = node;
+        node = node->prev;
+        MGA_FREE(temp);
+    }
+}
+
+static void _mga_malloc_destroy(mg_arena* arena) {
+    _mga_malloc_free_list(arena->_malloc_backend.cur_node);
+    _mga_malloc_free_list(arena->_malloc_backend.free_nodes);
+    
+    MGA_FREE(arena);
+}
+
+// Makes sure that size bytes aligned to align fit in the current node
+static mga_b32 _mga_malloc_fit(mg_arena* arena, mga_u64 size, mga_u32 align) {
+    mga_u64 pos_aligned = _mga_align_pos(arena, align);
+
+    if (pos_aligned > arena->_size || size > arena->_size - pos_aligned) {
+        last_error.code = MGA_ERR_OUT_OF_MEMORY;
+        last_error.msg = "Arena ran out of memory";
+        arena->_last_error = last_error;
+        arena->error_callback(last_error);
+        return MGA_FALSE;
+    }
+
+    if (pos_aligned + size <= arena->_fast_limit) {
+        return MGA_TRUE;
+    }
+
+    // The rest of the current node is skipped.
+    // The data of the new node can need up to align - 1 bytes of padding
+    mga_u64 start = arena->_pos;
+    mga_u64 min_size = size + align - 1;
+    mga_u64 unclamped_node_size = MGA_ALIGN_UP_POW2(MGA_MAX(min_size, 1), arena->_block_size);
+    mga_u64 node_size = MGA_MIN(unclamped_node_size, MGA_MAX(arena->_size - start, min_size));
+
+    _mga_malloc_node* node = _mga_malloc_node_reuse(arena, start, min_size);
+    if (node == NULL) {
+        node = _mga_malloc_node_create(start, node_size);
+    }
+
+    if (node == NULL) {
+        last_error.code = MGA_ERR_MALLOC_FAILED;
+        last_error.msg = "Failed to malloc new node";
+        arena->_last_error = last_error;
+        arena->error_callback(last_error);
+        return MGA_FALSE;
+    }
+
+    node->prev = arena->_malloc_backend.cur_node;
+    arena->_malloc_backend.cur_node = node;
+
+    _mga_malloc_update_fast(arena);
+
+    if (arena->_timeline != NULL) {
+        mga_timeline_sample(arena->_timeline);
+    }
+
+    pos_aligned = _mga_align_pos(arena, align);
+    if (pos_aligned + size > arena->_fast_limit) {
+        last_error.code = MGA_ERR_OUT_OF_MEMORY;
+        last_error.msg = "Arena ran out of memory";
+        arena->_last_error = last_error;
+        arena->error_callback(last_error);
+        return MGA_FALSE;
+    }
+
+    return MGA_TRUE;
+}
+
+static void _mga_malloc_pop_to(mg_arena* arena, mga_u64 pos) {
+    _mga_malloc_node* node = arena->_malloc_backend.cur_node;
+
+    while (node->prev != NULL && node->start > pos) {
+        _mga_malloc_node* temp = node;
+        node = node->prev;
+
+        _mga_malloc_node_release(arena, temp);
+    }
+
+    mga_b32 changed = node != arena->_malloc_backend.cur_node;
+
+    arena->_malloc_backend.cur_node = node;
+    arena->_pos = pos;
+
+    _mga_malloc_update_fast(arena);
+
+    if (changed && arena->_timeline != NULL) {
+        mga_timeline_sample(arena->_timeline);
+    }
+}
+
+/*
+Low Level Backend
+================================================================================
+  _    _____      __  _    _____   _____ _      ___   _   ___ _  _____ _  _ ___  
+ | |  / _ \ \    / / | |  | __\ \ / / __| |    | _ ) /_\ / __| |/ / __| \| |   \
+ | |_| (_) \ \/\/ /  | |__| _| \ V /| _|| |__  | _ \/ _ \ (__| ' <| _|| .` | |) |
+ |____\___/ \_/\_/   |____|___| \_/ |___|____| |___/_/ \_\___|_|\_\___|_|\_|___/ 
+
+================================================================================
+*/
+
+
+// The low level backend code also handles buffer arenas,
+// which are the same except that nothing is committed or released
+
+#define MGA_MIN_POS MGA_ALIGN_UP_POW2(sizeof(mg_arena), 64) 
+
+static void _mga_reserve_update_fast(mg_arena* arena) {
+    arena->_fast_limit = MGA_MIN(arena->_reserve_backend.commit_pos, arena->_reserve_backend.top_pos);
+}
+
+#ifdef MGA_MEM_RESERVE
+
+// The MGA_MEM_* options can be macros, so they are wrapped to get function pointers
+static void* _mga_default_reserve(mga_u64 size) { return MGA_MEM_RESERVE(size); }
+static mga_b32 _mga_default_commit(void* ptr, mga_u64 size) { return MGA_MEM_COMMIT(ptr, size); }
+static void _mga_default_decommit(void* ptr, mga_u64 size) { MGA_MEM_DECOMMIT(ptr, size); }
+static void _mga_default_release(void* ptr, mga_u64 size) { MGA_MEM_RELEASE(ptr, size); }
+
+static const mga_mem_funcs _mga_default_mem_funcs = {
+    _mga_default_reserve,
+    _mga_default_commit,
+    _mga_default_decommit,
+    _mga_default_release
+};
+
+#endif // MGA_MEM_RESERVE
+
+static mg_arena* _mga_reserve_create(const _mga_init_data* init_data, const mga_mem_funcs* mem) {
+    mg_arena* out = (mg_arena*)mem->reserve(init_data->max_size);
+
+    if (out == NULL) {
+        last_error.code = MGA_ERR_INIT_FAILED;
+        last_error.msg = "Failed to reserve initial memory for arena";
+        init_data->error_callback(last_error);
+        return NULL;
+    }
+
+    mga_u64 init_commit = MGA_MIN(init_data->block_size, init_data->max_size);
+    if (!mem->commit(out, init_commit)) {
+        mem->release(out, init_data->max_size);
+
+        last_error.code = MGA_ERR_INIT_FAILED;
+        last_error.msg = "Failed to commit initial memory for arena";
+        init_data->error_callback(last_error);
+        return NULL;
+    }
+
+    out->_pos = MGA_MIN_POS + init_data->color_offset;
+    out->_start_pos = MGA_MIN_POS + init_data->color_offset;
+    out->_backend = _MGA_BACKEND_RESERVE;
+    out->_size = init_data->max_size;
+    out->_block_size = init_data->block_size;
+    out->_align = init_data->align;
+    out->_reserve_backend.commit_pos = init_commit;
+    out->_reserve_backend.top_pos = init_data->max_size;
+    out->_reserve_backend.top_commit_pos = init_data->max_size;
+    out->_reserve_backend.retain_commit = MGA_FALSE;
+    out->_reserve_backend.mem = *mem;
+    out->_timeline = NULL;
+    out->_last_error.code = MGA_ERR_NONE;
+    out->_last_error.msg = "";
+    out->error_callback = init_data->error_callback;
+
+    out->_fast_base = (mga_u8*)out;
+    _mga_reserve_update_fast(out);
+
+    return out;
+}
+
+// The committed memory is always [0, commit_pos) and [top_commit_pos, size),
+// with commit_pos <= top_commit_pos. This moves both ranges to fit the
+// given bottom and top positions, only touching the memory that changed.
+static mga_b32 _mga_reserve_update_commit(mg_arena* arena, mga_u64 pos, mga_u64 top_pos) {
+    if (arena->_backend == _MGA_BACKEND_BUFFER) {
+        _mga_reserve_update_fast(arena);
+        return MGA_TRUE;
+    }
+
+    _mga_reserve_backend* backend = &arena->_reserve_backend;
+
+    mga_u64 commit_pos = backend->commit_pos;
+    mga_u64 top_commit_pos = backend->top_commit_pos;
+
+    mga_u64 new_commit = MGA_MIN(arena->_size, MGA_ALIGN_UP_POW2(pos, arena->_block_size));
+    mga_u64 new_top_commit = top_pos == arena->_size ?
+        arena->_size : MGA_ALIGN_DOWN_POW2(top_pos, arena->_block_size);
+
+    // Both committed ranges only grow, until the arena is shrunk
+    if (backend->retain_commit) {
+        new_commit = MGA_MAX(new_commit, commit_pos);
+        new_top_commit = MGA_MIN(new_top_commit, top_commit_pos);
+    }
+    new_top_commit = MGA_MAX(new_top_commit, new_commit);
+
+    // Newly required ranges, excluding anything the other end already has
+    mga_u64 commit_end = MGA_MIN(top_commit_pos, new_commit);
+    if (commit_end > commit_pos) {
+        if (!backend->mem.commit((void*)((mga_u8*)arena + commit_pos), commit_end - commit_pos)) {
+            return MGA_FALSE;
+        }
+    }
+    mga_u64 top_commit_start = MGA_MAX(commit_pos, new_top_commit);
+    if (top_commit_pos > top_commit_start) {
+        if (!backend->mem.commit((void*)((mga_u8*)arena + top_commit_start), top_commit_pos - top_commit_start)) {
+            return MGA_FALSE;
+        }
+    }
+
+    // Ranges that are no longer required by either end
+    mga_u64 decommit_end = MGA_MIN(commit_pos, new_top_commit);
+    if (decommit_end > new_commit) {
+        backend->mem.decommit((void*)((mga_u8*)arena + new_commit), decommit_end - new_commit);
+    }
+    mga_u64 top_decommit_start = MGA_MAX(top_commit_pos, new_commit);
+    if (new_top_commit > top_decommit_start) {
+        backend->mem.decommit((void*)((mga_u8*)arena + top_decommit_start), new_top_commit - top_decommit_start);
+    }
+
+    mga_b32 changed = new_commit != commit_pos || new_top_commit != top_commit_pos;
+
+    backend->commit_pos = new_commit;
+    backend->top_commit_pos = new_top_commit;
+
+    _mga_reserve_update_fast(arena);
+
+    if (changed && arena->_timeline != NULL) {
+        mga_timeline_sample(arena->_timeline);
+    }
+
+    return MGA_TRUE;
+}
+
+// Makes sure that size bytes aligned to align are committed
+static mga_b32 _mga_reserve_fit(mg_arena* arena, mga_u64 size, mga_u32 align) {
+    mga_u64 pos_aligned = _mga_align_pos(arena, align);
+    mga_u64 top_pos = arena->_reserve_backend.top_pos;
+
+    if (pos_aligned > top_pos || size > top_pos - pos_aligned) {
+        last_error.code = MGA_ERR_OUT_OF_MEMORY;
+        last_error.msg = "Arena ran out of memory";
+        arena->_last_error = last_error;
+        arena->error_callback(last_error);
+        return MGA_FALSE;
+    }
+
+    mga_u64 new_pos = pos_aligned + size;
+
+    if (new_pos > arena->_reserve_backend.commit_pos) {
+        if (!_mga_reserve_update_commit(arena, new_pos, top_pos)) {
+            last_error.code = MGA_ERR_COMMIT_FAILED;
+            last_error.msg = "Failed to commit memory";
+            arena->_last_error = last_error;
+            arena->error_callback(last_error);
+            return MGA_FALSE;
+        }
+    }
+
+    return MGA_TRUE;
+}
+
+static void _mga_reserve_pop_to(mg_arena* arena, mga_u64 pos) {
+    arena->_pos = pos;
+
+    // Decommitting cannot fail
+    _mga_reserve_update_commit(arena, arena->_pos, arena->_reserve_backend.top_pos);
+}
+
+static void* _mga_reserve_push_top(mg_arena* arena, mga_u64 size) {
+    mga_u64 top_pos = arena->_reserve_backend.top_pos;
+
+    if (size > top_pos || MGA_ALIGN_DOWN_POW2(top_pos - size, arena->_align) < arena->_pos) {
+        last_error.code = MGA_ERR_OUT_OF_MEMORY;
+        last_error.msg = "Arena ran out of memory";
+        arena->_last_error = last_error;
+        arena->error_callback(last_error);
+        return NULL;
+    }
+
+    mga_u64 new_top_pos = MGA_ALIGN_DOWN_POW2(top_pos - size, arena->_align);
+
+    if (new_top_pos < arena->_reserve_backend.top_commit_pos) {
+        if (!_mga_reserve_update_commit(arena, arena->_pos, new_top_pos)) {
+            last_error.code = MGA_ERR_COMMIT_FAILED;
+            last_error.msg = "Failed to commit memory";
+            arena->_last_error = last_error;
+            arena->error_callback(last_error);
+            return NULL;
+        }
+    }
+
+    arena->_reserve_backend.top_pos = new_top_pos;
+    _mga_reserve_update_fast(arena);
+
+    return (void*)((mga_u8*)arena + new_top_pos);
+}
+
+static void _mga_reserve_pop_top_to(mg_arena* arena, mga_u64 top_pos) {
+    if (top_pos > arena->_size || top_pos < arena->_reserve_backend.top_pos) {
+        last_error.code = MGA_ERR_CANNOT_POP_MORE;
+        last_error.msg = "Attempted to pop too much memory";
+        arena->_last_error = last_error;
+        arena->error_callback(last_error);
+
+        return;
+    }
+
+    arena->_reserve_backend.top_pos = top_pos;
+
+    _mga_reserve_update_commit(arena, arena->_pos, top_pos);
+}
+
+/*
+Buffer Backend
+===============================================================
+  ___ _   _ ___ ___ ___ ___   ___   _   ___ _  _____ _  _ ___  
+ | _ ) | | | __| __| __| _ \ | _ ) /_\ / __| |/ / __| \| |   \ 
+ | _ \ |_| | _|| _|| _||   / | _ \/ _ \ (__| ' <| _|| .` | |) |
+ |___/\___/|_| |_| |___|_|_\ |___/_/ \_\___|_|\_\___|_|\_|___/ 
+
+===============================================================
+*/
+
+mg_arena* mga_create_from_buffer(const mga_desc* desc, void* buffer, mga_u64 size) {
+    _mga_init_data init_data = _mga_init_common(desc);
+
+    // The arena struct is stored at the start of the buffer
+    mga_u64 offset = MGA_ALIGN_UP_POW2((uintptr_t)buffer, sizeof(void*)) - (uintptr_t)buffer;
+
+    if (buffer == NULL || size < offset + MGA_MIN_POS + init_data.color_offset) {
+        last_error.code = MGA_ERR_INIT_FAILED;
+        last_error.msg = "Buffer is too small for arena";
+        init_data.error_callback(last_error);
+        return NULL;
+    }
+
+    mg_arena* out = (mg_arena*)((mga_u8*)buffer + offset);
+    size -= offset;
+
+    out->_pos = MGA_MIN_POS + init_data.color_offset;
+    out->_start_pos = MGA_MIN_POS + init_data.color_offset;
+    out->_backend = _MGA_BACKEND_BUFFER;
+    out->_size = size;
+    out->_block_size = init_data.block_size;
+    out->_align = init_data.align;
+    out->_reserve_backend.commit_pos = size;
+    out->_reserve_backend.top_pos = size;
+    out->_reserve_backend.top_commit_pos = size;
+    out->_reserve_backend.retain_commit = MGA_FALSE;
+    MGA_MEMSET(&out->_reserve_backend.mem, 0, sizeof(mga_mem_funcs));
+    out->_timeline = NULL;
+    out->_last_error.code = MGA_ERR_NONE;
+    out->_last_error.msg = "";
+    out->error_callback = init_data.error_callback;
+
+    out->_fast_base = (mga_u8*)out;
+    _mga_reserve_update_fast(out);
+
+    return out;
+}
+
+mg_arena* mga_create_sub(mg_arena* parent, mga_u64 size) {
+    mga_u64 total_size = MGA_MIN_POS + size;
+    if (total_size < size) {
+        last_error.code = MGA_ERR_OUT_OF_MEMORY;
+        last_error.msg = "Sub arena size is too large";
+        parent->_last_error = last_error;
+        parent->error_callback(last_error);
+        return NULL;
+    }
+
+    // The parent reports its own errors
+    void* buffer = mga_push_aligned(parent, total_size, 64);
+    if (buffer == NULL) {
+        return NULL;
+    }
+
+    mga_desc desc = MGA_ZERO_INIT;
+    desc.align = parent->_align;
+    desc.error_callback = parent->error_callback;
+    mg_arena* out = mga_create_from_buffer(&desc, buffer, total_size);
+    out->_block_size = parent->_block_size;
+
+    return out;
+}
+
+
+/*
+All Backends
+=========================================================
+    _   _    _      ___   _   ___ _  _____ _  _ ___  ___ 
+   /_\ | |  | |    | _ ) /_\ / __| |/ / __| \| |   \/ __|
+  / _ \| |__| |__  | _ \/ _ \ (__| ' <| _|| .` | |) \__ \
+ /_/ \_\____|____| |___/_/ \_\___|_|\_\___|_|\_|___/|___/
+
+=========================================================
+*/
+
+
+mg_arena* mga_create(const mga_desc* desc) {
+    _mga_init_data init_data = _mga_init_common(desc);
+
+    mga_backend backend = desc->backend;
+    if (backend == MGA_BACKEND_DEFAULT) {
+#ifdef MGA_FORCE_MALLOC
+        backend = MGA_BACKEND_MALLOC;
+#else
+        backend = MGA_BACKEND_RESERVE;
+#endif
+    }
+
+    switch (backend) {
+        case MGA_BACKEND_MALLOC: {
+            return _mga_malloc_create(&init_data);
+        }
+        case MGA_BACKEND_RESERVE: {
+#ifdef MGA_MEM_RESERVE
+            return _mga_reserve_create(&init_data, &_mga_default_mem_funcs);
+#else
+            last_error.code = MGA_ERR_UNSUPPORTED;
+            last_error.msg = "The low level backend is not available on this platform";
+            init_data.error_callback(last_error);
+            return NULL;
+#endif
+        }
+        case MGA_BACKEND_CUSTOM: {
+            const mga_mem_funcs* mem = desc->mem_funcs;
+            if (mem == NULL || mem->reserve == NULL || mem->commit == NULL ||
+                mem->decommit == NULL || mem->release == NULL) {
+                last_error.code = MGA_ERR_INIT_FAILED;
+                last_error.msg = "Custom backend requires all of the mem_funcs";
+                init_data.error_callback(last_error);
+                return NULL;
+            }
+
+            return _mga_reserve_create(&init_data, mem);
+        }
+        default: break;
+    }
+
+    last_error.code = MGA_ERR_INIT_FAILED;
+    last_error.msg = "Invalid arena backend";
+    init_data.error_callback(last_error);
+    return NULL;
+}
+void mga_destroy(mg_arena* arena) {
+    switch (arena->_backend) {
+        case _MGA_BACKEND_MALLOC: {
+            _mga_malloc_destroy(arena);
+        } break;
+        case _MGA_BACKEND_RESERVE: {
+            arena->_reserve_backend.mem.release(arena, arena->_size);
+        } break;
+        // The memory of buffer arenas belongs to the user
+        default: break;
+    }
+}
+
+static mga_b32 _mga_fit(mg_arena* arena, mga_u64 size, mga_u32 align) {
+    if (arena->_backend == _MGA_BACKEND_MALLOC) {
+        return _mga_malloc_fit(arena, size, align);
+    }
+
+    return _mga_reserve_fit(arena, size, align);
+}
+
+void mga_pop(mg_arena* arena, mga_u64 size) {
+    if (size > arena->_pos - arena->_start_pos) {
+        last_error.code = MGA_ERR_CANNOT_POP_MORE;
+        last_error.msg = "Attempted to pop too much memory";
+        arena->_last_error = last_error;
+        arena->error_callback(last_error);
+
+        return;
+    }
+
+    if (arena->_backend == _MGA_BACKEND_MALLOC) {
+        _mga_malloc_pop_to(arena, arena->_pos - size);
+    } else {
+        _mga_reserve_pop_to(arena, arena->_pos - size);
+    }
+}
+
+void mga_reset(mg_arena* arena) {
+    if (arena->_backend != _MGA_BACKEND_MALLOC) {
+        arena->_reserve_backend.top_pos = arena->_size;
+    }
+
+    mga_pop_to(arena, arena->_start_pos);
+}
+
+mga_u64 mga_get_top_pos(mg_arena* arena) {
+    if (arena->_backend == _MGA_BACKEND_MALLOC) {
+        return arena->_size;
+    }
+
+    return arena->_reserve_backend.top_pos;
+}
+
+void* mga_push_top(mg_arena* arena, mga_u64 size) {
+    if (arena->_backend == _MGA_BACKEND_MALLOC) {
+        last_error.code = MGA_ERR_UNSUPPORTED;
+        last_error.msg = "Top allocations are not supported by the malloc backend";
+        arena->_last_error = last_error;
+        arena->error_callback(last_error);
+        return NULL;
+    }
+
+    return _mga_reserve_push_top(arena, size);
+}
+
+void mga_pop_top_to(mg_arena* arena, mga_u64 top_pos) {
+    if (arena->_backend != _MGA_BACKEND_MALLOC) {
+        _mga_reserve_pop_top_to(arena, top_pos);
+    }
+}
+void mga_reset_top(mg_arena* arena) {
+    mga_pop_top_to(arena, arena->_size);
+}
+
+mga_error mga_get_error(mg_arena* arena) {
+    mga_error* err = arena == NULL ? &last_error : &arena->_last_error;
+    mga_error temp = *err;
+
+    err->code = MGA_ERR_NONE;
+    err->msg = "";
+    
+    return temp;
+}
+
+mga_u64 mga_get_pos(mg_arena* arena) { return arena->_pos; }
+mga_u64 mga_get_size(mg_arena* arena) { return arena->_size; }
+mga_u32 mga_get_block_size(mg_arena* arena) { return arena->_block_size; }
+mga_u32 mga_get_align(mg_arena* arena) { return arena->_align; }
+mga_u64 mga_get_committed(mg_arena* arena) {
+    switch (arena->_backend) {
+        case _MGA_BACKEND_MALLOC: {
+            mga_u64 out = 0;
+            _mga_malloc_node* lists[2] = { arena->_malloc_backend.cur_node, arena->_malloc_backend.free_nodes };
+
+            for (mga_u32 i = 0; i < 2; i++) {
+                for (_mga_malloc_node* node = lists[i]; node != NULL; node = node->prev) {
+                    out += node->size;
+                }
+            }
+
+            return out;
+        }
+        case _MGA_BACKEND_RESERVE: {
+            _mga_reserve_backend* backend = &arena->_reserve_backend;
+            return backend->commit_pos + (arena->_size - backend->top_commit_pos);
+        }
+        default: break;
+    }
+
+    // The whole buffer is committed by the user
+    return arena->_size;
+}
+
+void* _mga_push_slow(mg_arena* arena, mga_u64 size, mga_u32 align) {
+    if (!_mga_fit(arena, size, align)) {
+        return NULL;
+    }
+
+    // The malloc backend can switch to a new node with a different base
+    mga_u64 pos_aligned = _mga_align_pos(arena, align);
+    arena->_pos = pos_aligned + size;
+
+    return (void*)(arena->_fast_base + pos_aligned);
+}
+void* mga_push_cache_line(mg_arena* arena, mga_u64 size) {
+    // Too large to pad, so this reports the error
+    if (size > UINT64_MAX - MGA_CACHE_LINE) {
+        return _mga_push_slow(arena, size, MGA_CACHE_LINE);
+    }
+
+    return mga_push_aligned(arena, MGA_ALIGN_UP_POW2(size, MGA_CACHE_LINE), MGA_CACHE_LINE);
+}
+void* mga_push_page(mg_arena* arena, mga_u64 size) {
+    mga_u32 page_size = MGA_MEM_PAGESIZE();
+
+    if (size > UINT64_MAX - page_size) {
+        return _mga_push_slow(arena, size, page_size);
+    }
+
+    return mga_push_aligned(arena, MGA_ALIGN_UP_POW2(size, page_size), page_size);
+}
+static void _mga_stream_copy(mga_u8* dst, const mga_u8* src, mga_u64 size) {
+#ifdef MGA_SSE2
+    // Stores have to be 16 byte aligned, the loads do not
+    mga_u64 head = MGA_MIN(size, (0 - (mga_u64)(uintptr_t)dst) & 15);
+    MGA_MEMCPY(dst, src, head);
+    dst += head;
+    src += head;
+    size -= head;
+
+    mga_u64 num_blocks = size / 64;
+    for (mga_u64 i = 0; i < num_blocks; i++) {
+        __m128i a = _mm_loadu_si128((const __m128i*)(src + 0));
+        __m128i b = _mm_loadu_si128((const __m128i*)(src + 16));
+        __m128i c = _mm_loadu_si128((const __m128i*)(src + 32));
+        __m128i d = _mm_loadu_si128((const __m128i*)(src + 48));
+
+        _mm_stream_si128((__m128i*)(dst + 0), a);
+        _mm_stream_si128((__m128i*)(dst + 16), b);
+        _mm_stream_si128((__m128i*)(dst + 32), c);
+        _mm_stream_si128((__m128i*)(dst + 48), d);
+
+        dst += 64;
+        src += 64;
+    }
+
+    // Streaming stores are weakly ordered
+    _mm_sfence();
+
+    MGA_MEMCPY(dst, src, size % 64);
+#else
+    MGA_MEMCPY(dst, src, size);
+#endif
+}
+
+void* mga_push_copy(mg_arena* arena, const void* src, mga_u64 size) {
+    mga_u8* out = (mga_u8*)mga_push(arena, size);
+    if (out == NULL) {
+        return NULL;
+    }
+
+    if (size >= MGA_STREAM_THRESHOLD) {
+        _mga_stream_copy(out, (const mga_u8*)src, size);
+    } else {
+        MGA_MEMCPY(out, src, size);
+    }
+
+    return (void*)out;
+}
+
+mga_b32 mga_push_batch(mg_arena* arena, const mga_u64* sizes, mga_u32 count, void** out_ptrs) {
+    // Offsets are relative to the aligned position, so they have the same alignment
+    mga_u64 total = 0;
+    for (mga_u32 i = 0; i < count; i++) {
+        mga_u64 offset = MGA_ALIGN_UP_POW2(total, arena->_align);
+        if (offset < total || sizes[i] > UINT64_MAX - offset) {
+            total = UINT64_MAX;
+            break;
+        }
+
+        total = offset + sizes[i];
+    }
+
+    mga_u8* base = (mga_u8*)mga_push(arena, total);
+
+    mga_u64 offset = 0;
+    for (mga_u32 i = 0; i < count; i++) {
+        if (base == NULL) {
+            out_ptrs[i] = NULL;
+            continue;
+        }
+
+        offset = MGA_ALIGN_UP_POW2(offset, arena->_align);
+        out_ptrs[i] = (void*)(base + offset);
+        offset += sizes[i];
+    }
+
+    return base != NULL;
+}
+mga_b32 mga_prepare(mg_arena* arena, mga_u64 size) {
+    return _mga_fit(arena, size, arena->_align);
+}
+
+void* mga_push_zero(mg_arena* arena, mga_u64 size) {
+    mga_u8* out = (mga_u8*)mga_push(arena, size);
+    if (out != NULL) {
+        MGA_MEMSET(out, 0, size);
+    }
+
+    return (void*)out;
+}
+void* mga_push_top_zero(mg_arena* arena, mga_u64 size) {
+    mga_u8* out = (mga_u8*)mga_push_top(arena, size);
+    if (out != NULL) {
+        MGA_MEMSET(out, 0, size);
+    }
+
+    return (void*)out;
+}
+
+void mga_pop_to(mg_arena* arena, mga_u64 pos) {
+    mga_pop(arena, arena->_pos - pos);
+}
+
+mga_b32 mga_extend(mg_arena* arena, void* ptr, mga_u64 old_size, mga_u64 new_size) {
+    if (ptr == NULL || new_size < old_size ||
+        (mga_u8*)ptr + old_size != arena->_fast_base + arena->_pos) {
+        return MGA_FALSE;
+    }
+
+    mga_u64 extra = new_size - old_size;
+
+    // A new node would not be contiguous with ptr
+    if (arena->_backend == _MGA_BACKEND_MALLOC) {
+        if (extra > arena->_fast_limit - arena->_pos) {
+            return MGA_FALSE;
+        }
+
+        arena->_pos += extra;
+        return MGA_TRUE;
+    }
+
+    // Positions are contiguous in the other backends
+    return mga_push_aligned(arena, extra, 1) != NULL;
+}
+
+mga_temp mga_temp_begin(mg_arena* arena) {
+    mga_temp out = MGA_ZERO_INIT;
+    out.arena = arena;
+    out._pos = arena->_pos;
+
+    return out;
+}
+void mga_temp_end(mga_temp temp) {
+    mga_pop_to(temp.arena, temp._pos);
+}
+
+// The in use scratch arenas are a bitmask
+#define MGA_SCRATCH_MAX 64
+
+#ifndef MGA_SCRATCH_COUNT
+#   define MGA_SCRATCH_COUNT 2
+#endif
+
+#if MGA_SCRATCH_COUNT < 1 || MGA_SCRATCH_COUNT > MGA_SCRATCH_MAX
+#   error "MG ARENA: MGA_SCRATCH_COUNT must be between 1 and 64"
+#endif
+
+#ifndef MGA_NO_STDIO
+static void _mga_scratch_on_error(mga_error err) {
+    fprintf(stderr, "MGA Scratch Error %u: %s\n", err.code, err.msg);
+}
+#endif
+
+#ifndef MGA_NO_STDIO
+#   define _MGA_SCRATCH_ERROR_CALLBACK _mga_scratch_on_error
+#else
+#   define _MGA_SCRATCH_ERROR_CALLBACK NULL
+#endif
+
+static MGA_THREAD_VAR mga_desc _mga_scratch_desc = {
+    MGA_MiB(64), MGA_KiB(256), 0, _MGA_SCRATCH_ERROR_CALLBACK,
+    MGA_BACKEND_DEFAULT, NULL, MGA_FALSE
+};
+static MGA_THREAD_VAR mg_arena* _mga_scratch_arenas[MGA_SCRATCH_MAX] = MGA_ZERO_INIT;
+static MGA_THREAD_VAR mga_u64 _mga_scratch_in_use = 0;
+static MGA_THREAD_VAR mga_u32 _mga_scratch_count = MGA_SCRATCH_COUNT;
+static MGA_THREAD_VAR mga_u64 _mga_scratch_peak = 0;
+static MGA_THREAD_VAR mga_b32 _mga_scratch_cleanup_registered = MGA_FALSE;
+
+// Scratch arenas are destroyed with a thread exit callback on the
+// first arena creation of every thread. The main thread is not included,
+// because the process is about to exit anyways
+#if !defined(MGA_NO_SCRATCH_CLEANUP) && (defined(MGA_PLATFORM_LINUX) || defined(MGA_PLATFORM_APPLE))
+
+#include <pthread.h>
+
+static pthread_key_t _mga_scratch_key;
+static pthread_once_t _mga_scratch_key_once = PTHREAD_ONCE_INIT;
+
+static void _mga_scratch_thread_exit(void* arg) {
+    MGA_UNUSED(arg);
+    mga_scratch_destroy();
+}
+static void _mga_scratch_key_create(void) {
+    pthread_key_create(&_mga_scratch_key, _mga_scratch_thread_exit);
+}
+static void _mga_scratch_register_cleanup(void) {
+    pthread_once(&_mga_scratch_key_once, _mga_scratch_key_create);
+    // Destructors are only called for non NULL values
+    pthread_setspecific(_mga_scratch_key, (void*)1);
+}
+
+#elif !defined(MGA_NO_SCRATCH_CLEANUP) && defined(MGA_PLATFORM_WIN32)
+
+static DWORD _mga_scratch_fls = FLS_OUT_OF_INDEXES;
+static INIT_ONCE _mga_scratch_fls_once = INIT_ONCE_STATIC_INIT;
+
+static VOID WINAPI _mga_scratch_thread_exit(PVOID arg) {
+    if (arg != NULL) {
+        mga_scratch_destroy();
+    }
+}
+static BOOL CALLBACK _mga_scratch_fls_create(PINIT_ONCE once, PVOID param, PVOID* context) {
+    MGA_UNUSED(once); MGA_UNUSED(param); MGA_UNUSED(context);
+    _mga_scratch_fls = FlsAlloc(_mga_scratch_thread_exit);
+    return TRUE;
+}
+static void _mga_scratch_register_cleanup(void) {
+    InitOnceExecuteOnce(&_mga_scratch_fls_once, _mga_scratch_fls_create, NULL, NULL);
+    if (_mga_scratch_fls != FLS_OUT_OF_INDEXES) {
+        FlsSetValue(_mga_scratch_fls, (PVOID)1);
+    }
+}
+
+#else
+
+static void _mga_scratch_register_cleanup(void) { }
+
+#endif
+
+static mga_u32 _mga_ctz64(mga_u64 x) {
+#if defined(_MSC_VER) && !defined(__clang__)
+    unsigned long index = 0;
+    _BitScanForward64(&index, x);
+    return (mga_u32)index;
+#else
+    return (mga_u32)__builtin_ctzll(x);
+#endif
+}
+
+static mga_b32 _mga_scratch_in_conflicts(mg_arena* arena, mg_arena** conflicts, mga_u32 num_conflicts) {
+    for (mga_u32 i = 0; i < num_conflicts; i++) {
+        if (arena == conflicts[i]) {
+            return MGA_TRUE;
+        }
+    }
+
+    return MGA_FALSE;
+}
+
+void mga_scratch_set_desc(const mga_desc* desc) {
+    if (_mga_scratch_arenas[0] == NULL) {
+        _mga_scratch_desc = *desc;
+    }
+}
+void mga_scratch_set_count(mga_u32 count) {
+    count = MGA_MAX(1, MGA_MIN(count, MGA_SCRATCH_MAX));
+
+    // Arenas past the new count are destroyed, unless they are in use
+    for (mga_u32 i = count; i < MGA_SCRATCH_MAX; i++) {
+        if (_mga_scratch_arenas[i] != NULL && (_mga_scratch_in_use & ((mga_u64)1 << i)) == 0) {
+            mga_destroy(_mga_scratch_arenas[i]);
+            _mga_scratch_arenas[i] = NULL;
+        }
+    }
+
+    _mga_scratch_count = count;
+}
+mga_temp mga_scratch_get(mg_arena** conflicts, mga_u32 num_conflicts) {
+    mga_u64 count_mask = _mga_scratch_count == 64 ?
+        ~(mga_u64)0 : (((mga_u64)1 << _mga_scratch_count) - 1);
+    mga_u64 free_mask = ~_mga_scratch_in_use & count_mask;
+
+    // Conflicts are almost always arenas that are in use,
+    // so the first free arena is usually the answer
+    while (free_mask != 0) {
+        mga_u32 index = _mga_ctz64(free_mask);
+        mg_arena* arena = _mga_scratch_arenas[index];
+
+        if (arena == NULL) {
+            arena = mga_create(&_mga_scratch_desc);
+            if (arena == NULL) {
+                mga_temp out = MGA_ZERO_INIT;
+                return out;
+            }
+            if (arena->_backend == _MGA_BACKEND_RESERVE) {
+                arena->_reserve_backend.retain_commit = MGA_TRUE;
+            }
+            _mga_scratch_arenas[index] = arena;
+
+            if (!_mga_scratch_cleanup_registered) {
+                _mga_scratch_register_cleanup();
+                _mga_scratch_cleanup_registered = MGA_TRUE;
+            }
+        } else if (_mga_scratch_in_conflicts(arena, conflicts, num_conflicts)) {
+            free_mask &= free_mask - 1;
+            continue;
+        }
+
+        _mga_scratch_in_use |= (mga_u64)1 << index;
+
+        mga_temp out = mga_temp_begin(arena);
+        out._scratch_index = index + 1;
+        return out;
+    }
+
+    // Every arena is in use, so the deepest one without a conflict is shared.
+    // This is still safe as long as the scratch arenas are released in order
+    for (mga_u32 i = _mga_scratch_count; i > 0; i--) {
+        mg_arena* arena = _mga_scratch_arenas[i - 1];
+
+        if (arena != NULL && !_mga_scratch_in_conflicts(arena, conflicts, num_conflicts)) {
+            return mga_temp_begin(arena);
+        }
+    }
+
+    mga_temp out = MGA_ZERO_INIT;
+    return out;
+}
+void mga_scratch_release(mga_temp scratch) {
+    mga_u64 usage = 0;
+    for (mga_u64 mask = _mga_scratch_in_use; mask != 0; mask &= mask - 1) {
+        mg_arena* arena = _mga_scratch_arenas[_mga_ctz64(mask)];
+        usage += arena->_pos - arena->_start_pos;
+    }
+    _mga_scratch_peak = MGA_MAX(_mga_scratch_peak, usage);
+
+    if (scratch._scratch_index != 0) {
+        _mga_scratch_in_use &= ~((mga_u64)1 << (scratch._scratch_index - 1));
+    }
+
+    mga_temp_end(scratch);
+}
+void mga_scratch_shrink(void) {
+    for (mga_u32 i = 0; i < MGA_SCRATCH_MAX; i++) {
+        mg_arena* arena = _mga_scratch_arenas[i];
+        if (arena == NULL || (_mga_scratch_in_use & ((mga_u64)1 << i)) != 0) {
+            continue;
+        }
+
+        if (arena->_backend == _MGA_BACKEND_MALLOC) {
+            _mga_malloc_free_list(arena->_malloc_backend.free_nodes);
+            arena->_malloc_backend.free_nodes = NULL;
+            arena->_malloc_backend.num_free_nodes = 0;
+        } else {
+            arena->_reserve_backend.retain_commit = MGA_FALSE;
+            _mga_reserve_update_commit(arena, arena->_pos, arena->_reserve_backend.top_pos);
+            arena->_reserve_backend.retain_commit = MGA_TRUE;
+        }
+    }
+}
+void mga_scratch_destroy(void) {
+    for (mga_u32 i = 0; i < MGA_SCRATCH_MAX; i++) {
+        if (_mga_scratch_arenas[i] != NULL) {
+            mga_destroy(_mga_scratch_arenas[i]);
+            _mga_scratch_arenas[i] = NULL;
+        }
+    }
+
+    _mga_scratch_in_use = 0;
+}
+mga_u64 mga_scratch_get_peak(void) {
+    return _mga_scratch_peak;
+}
+void mga_scratch_reset_peak(void) {
+    _mga_scratch_peak = 0;
+}
+
+/*
+Ring Buffers
+=====================================================
+  ___ ___ _  _  ___   ___ _   _ ___ ___ ___ ___  ___ 
+ | _ \_ _| \| |/ __| | _ ) | | | __| __| __| _ \/ __|
+ |   /| || .` | (_ | | _ \ |_| | _|| _|| _||   /\__ \
+ |_|_\___|_|\_|\___| |___/\___/|_| |_| |___|_|_\|___/
+
+=====================================================
+*/
+
+// The ring struct is stored in the memory right before the first view
+static mga_u64 _mga_ring_header_size(void) {
+    return MGA_ALIGN_UP_POW2(sizeof(mga_ring), _mga_ring_granularity());
+}
+
+mga_ring* mga_ring_create(const mga_ring_desc* desc) {
+    mga_error_callback* error_callback = desc->error_callback == NULL ?
+        _mga_empty_error_callback : desc->error_callback;
+
+    // The size has to be a power of 2 for the position wrapping
+    mga_u64 size = _mga_ring_granularity();
+    while (size < desc->desired_size) {
+        size <<= 1;
+    }
+
+    mga_u32 align = desc->align == 0 ? (sizeof(void*)) : desc->align;
+
+    // Pushes round their size up to align
+    if ((align & (align - 1)) != 0) {
+        last_error.code = MGA_ERR_INIT_FAILED;
+        last_error.msg = "Ring align must be a power of 2";
+        error_callback(last_error);
+        return NULL;
+    }
+
+    mga_u64 header_size = _mga_ring_header_size();
+    void* handle = NULL;
+    mga_ring* out = (mga_ring*)_mga_ring_map(header_size, size, &handle);
+
+    if (out == NULL) {
+        last_error.code = MGA_ERR_INIT_FAILED;
+        last_error.msg = "Failed to map memory for ring";
+        error_callback(last_error);
+        return NULL;
+    }
+
+    MGA_MEMSET(out, 0, sizeof(mga_ring));
+    out->_data = (mga_u8*)out + header_size;
+    out->_size = size;
+    out->_align = align;
+    out->_handle = handle;
+    out->_producer_error.code = MGA_ERR_NONE;
+    out->_producer_error.msg = "";
+    out->_consumer_error = out->_producer_error;
+    out->error_callback = error_callback;
+
+    return out;
+}
+void mga_ring_destroy(mga_ring* ring) {
+    _mga_ring_unmap(ring, _mga_ring_header_size(), ring->_size, ring->_handle);
+}
+
+static mga_error _mga_ring_take_error(mga_error* err) {
+    mga_error temp = *err;
+
+    err->code = MGA_ERR_NONE;
+    err->msg = "";
+
+    return temp;
+}
+mga_error mga_ring_get_error(mga_ring* ring) {
+    if (ring == NULL) {
+        return _mga_ring_take_error(&last_error);
+    }
+
+    return _mga_ring_take_error(ring->_producer_error.code != MGA_ERR_NONE ?
+        &ring->_producer_error : &ring->_consumer_error);
+}
+mga_error mga_ring_get_producer_error(mga_ring* ring) {
+    return _mga_ring_take_error(&ring->_producer_error);
+}
+mga_error mga_ring_get_consumer_error(mga_ring* ring) {
+    return _mga_ring_take_error(&ring->_consumer_error);
+}
+mga_u64 mga_ring_get_size(mga_ring* ring) { return ring->_size; }
+
+mga_u64 mga_ring_get_free(mga_ring* ring) {
+    mga_u64 tail = MGA_ATOMIC_LOAD_ACQUIRE(&ring->_tail);
+    return ring->_size - (ring->_write_pos - tail);
+}
+
+void* mga_ring_push(mga_ring* ring, mga_u64 size) {
+    mga_u64 size_aligned = MGA_ALIGN_UP_POW2(size, ring->_align);
+
+    if (size_aligned > mga_ring_get_free(ring)) {
+        last_error.code = MGA_ERR_OUT_OF_MEMORY;
+        last_error.msg = "Ring ran out of memory";
+        ring->_producer_error = last_error;
+        ring->error_callback(last_error);
+        return NULL;
+    }
+
+    void* out = (void*)(ring->_data + (ring->_write_pos & (ring->_size - 1)));
+    ring->_write_pos += size_aligned;
+
+    return out;
+}
+void mga_ring_publish(mga_ring* ring) {
+    MGA_ATOMIC_STORE_RELEASE(&ring->_head, ring->_write_pos);
+}
+
+void* mga_ring_peek(mga_ring* ring, mga_u64* available) {
+    mga_u64 head = MGA_ATOMIC_LOAD_ACQUIRE(&ring->_head);
+    mga_u64 tail = ring->_tail;
+
+    if (available != NULL) {
+        *available = head - tail;
+    }
+
+    return (void*)(ring->_data + (tail & (ring->_size - 1)));
+}
+void mga_ring_release(mga_ring* ring, mga_u64 size) {
+    mga_u64 size_aligned = MGA_ALIGN_UP_POW2(size, ring->_align);
+    mga_u64 head = MGA_ATOMIC_LOAD_ACQUIRE(&ring->_head);
+    mga_u64 tail = ring->_tail;
+
+    if (size_aligned > head - tail) {
+        last_error.code = MGA_ERR_CANNOT_POP_MORE;
+        last_error.msg = "Attempted to release more memory than was published";
+        ring->_consumer_error = last_error;
+        ring->error_callback(last_error);
+        return;
+    }
+
+    MGA_ATOMIC_STORE_RELEASE(&ring->_tail, tail + size_aligned);
+}
+
+/*
+Slot Maps
+=============================================
+  ___ _    ___ _____   __  __   _   ___  ___ 
+ / __| |  / _ \_   _| |  \/  | /_\ | _ \/ __|
+ \__ \ |_| (_) || |   | |\/| |/ _ \|  _/\__ \
+ |___/____\___/ |_|   |_|  |_/_/ \_\_|  |___/
+
+=============================================
+*/
+
+#define _MGA_SLOT_NONE UINT32_MAX
+
+static mga_slot_handle _mga_slot_handle(mga_u32 index, mga_u32 generation) {
+    mga_slot_handle out;
+    out.index = index;
+    out.generation = generation;
+
+    return out;
+}
+
+typedef struct {
+    mga_u64 elem_slots;
+    mga_u64 slots;
+    mga_u64 size;
+} _mga_slot_map_layout;
+
+static _mga_slot_map_layout _mga_slot_map_get_layout(mga_u32 elem_size, mga_u32 capacity) {
+    _mga_slot_map_layout out;
+
+    out.elem_slots = MGA_ALIGN_UP_POW2((mga_u64)elem_size * capacity, sizeof(mga_u32));
+    out.slots = out.elem_slots + (mga_u64)capacity * sizeof(mga_u32);
+    out.size = out.slots + (mga_u64)capacity * sizeof(_mga_slot);
+
+    return out;
+}
+
+mga_slot_map* mga_slot_map_create(mg_arena* arena, mga_u32 elem_size, mga_u32 capacity) {
+    capacity = capacity == 0 ? 16 : capacity;
+    _mga_slot_map_layout layout = _mga_slot_map_get_layout(elem_size, capacity);
+
+    mga_slot_map* out = MGA_PUSH_STRUCT(arena, mga_slot_map);
+    if (out == NULL) {
+        return NULL;
+    }
+
+    mga_u8* data = (mga_u8*)mga_push_aligned(arena, layout.size, MGA_CACHE_LINE);
+    if (data == NULL) {
+        return NULL;
+    }
+
+    out->_arena = arena;
+    out->_elem_size = elem_size;
+    out->_count = 0;
+    out->_capacity = capacity;
+    out->_num_slots = 0;
+    out->_free_slot = _MGA_SLOT_NONE;
+    out->_data = data;
+    out->_elem_slots = (mga_u32*)(data + layout.elem_slots);
+    out->_slots = (_mga_slot*)(data + layout.slots);
+
+    return out;
+}
+
+static mga_b32 _mga_slot_map_grow(mga_slot_map* map) {
+    if (map->_capacity > UINT32_MAX / 2) {
+        last_error.code = MGA_ERR_OUT_OF_MEMORY;
+        last_error.msg = "Slot map is too large";
+        map->_arena->_last_error = last_error;
+        map->_arena->error_callback(last_error);
+        return MGA_FALSE;
+    }
+
+    _mga_slot_map_layout old_layout = _mga_slot_map_get_layout(map->_elem_size, map->_capacity);
+    _mga_slot_map_layout new_layout = _mga_slot_map_get_layout(map->_elem_size, map->_capacity * 2);
+
+    mga_u8* data = map->_data;
+    if (!mga_extend(map->_arena, data, old_layout.size, new_layout.size)) {
+        data = (mga_u8*)mga_push_aligned(map->_arena, new_layout.size, MGA_CACHE_LINE);
+        if (data == NULL) {
+            return MGA_FALSE;
+        }
+
+        MGA_MEMCPY(data, map->_data, (mga_u64)map->_elem_size * map->_count);
+    }
+
+    // When the map grows in place, the arrays overlap their old positions,
+    // so the slots have to move before the element slots
+    MGA_MEMMOVE(data + new_layout.slots, map->_slots, sizeof(_mga_slot) * map->_num_slots);
+    MGA_MEMMOVE(data + new_layout.elem_slots, map->_elem_slots, sizeof(mga_u32) * map->_count);
+
+    map->_capacity *= 2;
+    map->_data = data;
+    map->_elem_slots = (mga_u32*)(data + new_layout.elem_slots);
+    map->_slots = (_mga_slot*)(data + new_layout.slots);
+
+    return MGA_TRUE;
+}
+
+mga_slot_handle mga_slot_map_insert(mga_slot_map* map, const void* elem) {
+    if (map->_count == map->_capacity && !_mga_slot_map_grow(map)) {
+        return _mga_slot_handle(0, 0);
+    }
+
+    // There are never more slots than the capacity, because free slots are reused first
+    mga_u32 slot_index = map->_free_slot;
+    if (slot_index != _MGA_SLOT_NONE) {
+        map->_free_slot = map->_slots[slot_index].index;
+    } else {
+        slot_index = map->_num_slots++;
+        map->_slots[slot_index].generation = 0;
+    }
+
+    _mga_slot* slot = &map->_slots[slot_index];
+    slot->index = map->_count;
+    slot->generation++;
+
+    map->_elem_slots[map->_count] = slot_index;
+
+    mga_u8* out = map->_data + (mga_u64)map->_elem_size * map->_count;
+    if (elem != NULL) {
+        MGA_MEMCPY(out, elem, map->_elem_size);
+    } else {
+        MGA_MEMSET(out, 0, map->_elem_size);
+    }
+
+    map->_count++;
+
+    return _mga_slot_handle(slot_index, slot->generation);
+}
+
+static _mga_slot* _mga_slot_map_lookup(mga_slot_map* map, mga_slot_handle handle) {
+    if (handle.index >= map->_num_slots || (handle.generation & 1) == 0) {
+        return NULL;
+    }
+
+    _mga_slot* slot = &map->_slots[handle.index];
+    return slot->generation == handle.generation ? slot : NULL;
+}
+
+void* mga_slot_map_get(mga_slot_map* map, mga_slot_handle handle) {
+    _mga_slot* slot = _mga_slot_map_lookup(map, handle);
+    if (slot == NULL) {
+        return NULL;
+    }
+
+    return (void*)(map->_data + (mga_u64)map->_elem_size * slot->index);
+}
+
+mga_b32 mga_slot_map_remove(mga_slot_map* map, mga_slot_handle handle) {
+    _mga_slot* slot = _mga_slot_map_lookup(map, handle);
+    if (slot == NULL) {
+        return MGA_FALSE;
+    }
+
+    mga_u32 last = map->_count - 1;
+    if (slot->index != last) {
+        MGA_MEMCPY(
+            map->_data + (mga_u64)map->_elem_size * slot->index,
+            map->_data + (mga_u64)map->_elem_size * last,
+            map->_elem_size
+        );
+
+        mga_u32 moved_slot = map->_elem_slots[last];
+        map->_elem_slots[slot->index] = moved_slot;
+        map->_slots[moved_slot].index = slot->index;
+    }
+
+    map->_count--;
+
+    slot->generation++;
+    slot->index = map->_free_slot;
+    map->_free_slot = handle.index;
+
+    return MGA_TRUE;
+}
+
+void mga_slot_map_clear(mga_slot_map* map) {
+    for (mga_u32 i = 0; i < map->_count; i++) {
+        mga_u32 slot_index = map->_elem_slots[i];
+        _mga_slot* slot = &map->_slots[slot_index];
+
+        slot->generation++;
+        slot->index = map->_free_slot;
+        map->_free_slot = slot_index;
+    }
+
+    map->_count = 0;
+}
+
+mga_u32 mga_slot_map_count(mga_slot_map* map) { return map->_count; }
+void* mga_slot_map_data(mga_slot_map* map) { return (void*)map->_data; }
+
+mga_slot_handle mga_slot_map_handle_at(mga_slot_map* map, mga_u32 index) {
+    if (index >= map->_count) {
+        return _mga_slot_handle(0, 0);
+    }
+
+    mga_u32 slot_index = map->_elem_slots[index];
+    return _mga_slot_handle(slot_index, map->_slots[slot_index].generation);
+}
+
+/*
+Bucket Arrays
+===============================================================
+  ___ _   _  ___ _  _____ _____     _   ___ ___    ___   _____ 
+ | _ ) | | |/ __| |/ / __|_   _|   /_\ | _ \ _ \  /_\ \ / / __|
+ | _ \ |_| | (__| ' <| _|  | |    / _ \|   /   / / _ \ V /\__ \
+ |___/\___/ \___|_|\_\___| |_|   /_/ \_\_|_\_|_\/_/ \_\_| |___/
+
+===============================================================
+*/
+
+// The elements of a bucket start right after it
+#define _MGA_BUCKET_HEADER_SIZE MGA_ALIGN_UP_POW2(sizeof(mga_bucket), 16)
+
+mga_bucket_array* mga_bucket_array_create(mg_arena* arena, mga_u32 elem_size, mga_u32 bucket_capacity) {
+    mga_bucket_array* out = MGA_PUSH_STRUCT(arena, mga_bucket_array);
+    if (out == NULL) {
+        return NULL;
+    }
+
+    out->_arena = arena;
+    out->_elem_size = elem_size;
+    out->_bucket_capacity = bucket_capacity == 0 ? 64 : bucket_capacity;
+    out->_count = 0;
+    out->_first = NULL;
+    out->_last = NULL;
+
+    return out;
+}
+
+void* mga_bucket_array_push(mga_bucket_array* arr, const void* elem) {
+    mga_bucket* bucket = arr->_last;
+
+    if (bucket == NULL || bucket->count == arr->_bucket_capacity) {
+        mga_u64 size = _MGA_BUCKET_HEADER_SIZE + (mga_u64)arr->_elem_size * arr->_bucket_capacity;
+        bucket = (mga_bucket*)mga_push_aligned(arr->_arena, size, MGA_CACHE_LINE);
+        if (bucket == NULL) {
+            return NULL;
+        }
+
+        bucket->next = NULL;
+        bucket->count = 0;
+        bucket->data = (mga_u8*)bucket + _MGA_BUCKET_HEADER_SIZE;
+
+        if (arr->_last == NULL) {
+            arr->_first = bucket;
+        } else {
+            arr->_last->next = bucket;
+        }
+        arr->_last = bucket;
+    }
+
+    mga_u8* out = bucket->data + (mga_u64)arr->_elem_size * bucket->count;
+    if (elem != NULL) {
+        MGA_MEMCPY(out, elem, arr->_elem_size);
+    } else {
+        MGA_MEMSET(out, 0, arr->_elem_size);
+    }
+
+    bucket->count++;
+    arr->_count++;
+
+    return (void*)out;
+}
+
+mga_u64 mga_bucket_array_count(mga_bucket_array* arr) { return arr->_count; }
+
+mga_bucket* mga_bucket_array_first(mga_bucket_array* arr) {
+    if (arr->_first != NULL) {
+        MGA_PREFETCH(arr->_first->next);
+    }
+
+    return arr->_first;
+}
+mga_bucket* mga_bucket_next(mga_bucket* bucket) {
+    mga_bucket* next = bucket->next;
+
+    // Buckets can be far apart in the arena, so the hardware prefetcher
+    // does not find the next one on its own
+    if (next != NULL && next->next != NULL) {
+        MGA_PREFETCH(next->next);
+    }
+
+    return next;
+}
+
+/*
+Strings
+==================================
+  ___ _____ ___ ___ _  _  ___ ___ 
+ / __|_   _| _ \_ _| \| |/ __/ __|
+ \__ \ | | |   /| || .` | (_ \__ \
+ |___/ |_| |_|_\___|_|\_|\___|___/
+
+==================================
+*/
+
+static mga_str8 _mga_str8(mga_u64 size, mga_u8* str) {
+    mga_str8 out;
+    out.size = size;
+    out.str = str;
+
+    return out;
+}
+
+mga_str8 mga_str8_from_cstr(const char* cstr) {
+    const char* ptr = cstr;
+    for (; *ptr != 0; ptr++);
+
+    return _mga_str8((mga_u64)(ptr - cstr), (mga_u8*)cstr);
+}
+
+mga_b32 mga_str8_equal(mga_str8 a, mga_str8 b) {
+    if (a.size != b.size) {
+        return MGA_FALSE;
+    }
+
+    return a.size == 0 || MGA_MEMCMP(a.str, b.str, a.size) == 0;
+}
+
+// Eight bytes at a time, with the finalizer of MurmurHash3
+mga_u64 mga_str8_hash(mga_str8 str) {
+    mga_u64 hash = 0x9e3779b97f4a7c15ull ^ str.size;
+
+    mga_u64 i = 0;
+    for (; i + 8 <= str.size; i += 8) {
+        mga_u64 word = 0;
+        MGA_MEMCPY(&word, str.str + i, 8);
+
+        hash = (hash ^ word) * 0xff51afd7ed558ccdull;
+        hash ^= hash >> 32;
+    }
+
+    if (i < str.size) {
+        mga_u64 word = 0;
+        MGA_MEMCPY(&word, str.str + i, str.size - i);
+
+        hash = (hash ^ word) * 0xff51afd7ed558ccdull;
+    }
+
+    hash ^= hash >> 33;
+    hash *= 0xc4ceb9fe1a85ec53ull;
+    hash ^= hash >> 33;
+
+    return hash;
+}
+
+mga_str8_builder mga_str8_builder_begin(mg_arena* arena) {
+    mga_str8_builder out = MGA_ZERO_INIT;
+    out._arena = arena;
+    out._str = arena->_fast_base + arena->_pos;
+
+    return out;
+}
+mga_str8 mga_str8_builder_end(mga_str8_builder* builder) {
+    return _mga_str8(builder->_size, builder->_str);
+}
+
+// Makes room for size more bytes and returns where they go
+static mga_u8* _mga_str8_builder_grow(mga_str8_builder* builder, mga_u64 size) {
+    mg_arena* arena = builder->_arena;
+
+    if (builder->_size == 0) {
+        builder->_str = (mga_u8*)mga_push_aligned(arena, size, 1);
+        if (builder->_str == NULL) {
+            return NULL;
+        }
+    } else if (!mga_extend(arena, builder->_str, builder->_size, builder->_size + size)) {
+        // Something else is at the end of the arena, so the string moves once
+        mga_u8* str = (mga_u8*)mga_push_aligned(arena, builder->_size + size, 1);
+        if (str == NULL) {
+            return NULL;
+        }
+
+        MGA_MEMCPY(str, builder->_str, builder->_size);
+        builder->_str = str;
+    }
+
+    mga_u8* out = builder->_str + builder->_size;
+    builder->_size += size;
+
+    return out;
+}
+
+mga_b32 mga_str8_append(mga_str8_builder* builder, mga_str8 str) {
+    if (str.size == 0) {
+        return MGA_TRUE;
+    }
+
+    mga_u8* out = _mga_str8_builder_grow(builder, str.size);
+    if (out == NULL) {
+        return MGA_FALSE;
+    }
+
+    MGA_MEMCPY(out, str.str, str.size);
+
+    return MGA_TRUE;
+}
+
+mga_b32 mga_str8_append_u64(mga_str8_builder* builder, mga_u64 value) {
+    // Digits are written backwards from the end of the buffer
+    mga_u8 buffer[20];
+    mga_u32 start = sizeof(buffer);
+
+    do {
+        buffer[--start] = (mga_u8)('0' + value % 10);
+        value /= 10;
+    } while (value != 0);
+
+    return mga_str8_append(builder, _mga_str8(sizeof(buffer) - start, buffer + start));
+}
+mga_b32 mga_str8_append_i64(mga_str8_builder* builder, mga_i64 value) {
+    if (value < 0) {
+        if (!mga_str8_append(builder, MGA_STR8("-"))) {
+            return MGA_FALSE;
+        }
+
+        // Negating INT64_MIN as a signed number would overflow
+        return mga_str8_append_u64(builder, 0 - (mga_u64)value);
+    }
+
+    return mga_str8_append_u64(builder, (mga_u64)value);
+}
+
+#ifndef MGA_NO_STDIO
+
+mga_b32 mga_str8_appendf(mga_str8_builder* builder, const char* fmt, ...) {
+    mg_arena* arena = builder->_arena;
+
+    // The first attempt formats into the rest of the fast region.
+    // Those bytes are only pushed if the string fits
+    mga_u8* end = arena->_fast_base + arena->_pos;
+    mga_u64 available = arena->_fast_limit - arena->_pos;
+    if (builder->_size != 0 && builder->_str + builder->_size != end) {
+        available = 0;
+    }
+
+    va_list args;
+    va_start(args, fmt);
+    int len = vsnprintf((char*)end, available, fmt, args);
+    va_end(args);
+
+    if (len < 0) {
+        return MGA_FALSE;
+    }
+
+    if ((mga_u64)len < available) {
+        if (builder->_size == 0) {
+            builder->_str = end;
+        }
+
+        arena->_pos += (mga_u64)len;
+        builder->_size += (mga_u64)len;
+
+        return MGA_TRUE;
+    }
+
+    // One more byte for the null terminator, which is popped after
+    mga_u8* out = _mga_str8_builder_grow(builder, (mga_u64)len + 1);
+    if (out == NULL) {
+        return MGA_FALSE;
+    }
+
+    va_start(args, fmt);
+    vsnprintf((char*)out, (mga_u64)len + 1, fmt, args);
+    va_end(args);
+
+    mga_pop(arena, 1);
+    builder->_size--;
+
+    return MGA_TRUE;
+}
+
+#endif // MGA_NO_STDIO
+
+mga_intern_table* mga_intern_table_create(mg_arena* arena, mga_u32 capacity) {
+    mga_u32 pow2_capacity = 16;
+    while (pow2_capacity < capacity && pow2_capacity < ((mga_u32)1 << 31)) {
+        pow2_capacity <<= 1;
+    }
+
+    mga_intern_table* out = MGA_PUSH_STRUCT(arena, mga_intern_table);
+    if (out == NULL) {
+        return NULL;
+    }
 
-    out->_malloc_backend.cur_node = (_mga_malloc_node*)malloc(sizeof(_mga_malloc_node));
-    *out->_malloc_backend.cur_node = (_mga_malloc_node){
-        .prev = NULL,
-        .size = out->_block_size,
-        .pos = 0,
-        .data = (mga_u8*)malloc(out->_block_size)
-    };
+    mga_interned** slots = MGA_PUSH_ZERO_ARRAY(arena, mga_interned*, pow2_capacity);
+    if (slots == NULL) {
+        return NULL;
+    }
+
+    out->_arena = arena;
+    out->_slots = slots;
+    out->_capacity = pow2_capacity;
+    out->_count = 0;
 
     return out;
 }
-void mga_destroy(mg_arena* arena) {
-    _mga_malloc_node* node = arena->_malloc_backend.cur_node;
-    while (node != NULL) {
-        free(node->data);
 
-        _mga_malloc_node* temp = node;
-        node = node->prev;
-        free(temp);
+// Returns the slot of str, or the empty slot where it would go
+static mga_interned** _mga_intern_lookup(mga_intern_table* table, mga_str8 str, mga_u64 hash) {
+    mga_u32 mask = table->_capacity - 1;
+    mga_u32 index = (mga_u32)hash & mask;
+
+    while (table->_slots[index] != NULL) {
+        mga_interned* entry = table->_slots[index];
+        if (entry->hash == hash && mga_str8_equal(entry->str, str)) {
+            break;
+        }
+
+        index = (index + 1) & mask;
     }
-    
-    free(arena);
+
+    return &table->_slots[index];
 }
 
-void* mga_push(mg_arena* arena, mga_u64 size) {
-    if (arena->_pos + size > arena->_size) {
+// The old slots stay in the arena, but the entries do not move
+static mga_b32 _mga_intern_grow(mga_intern_table* table) {
+    if (table->_capacity >= ((mga_u32)1 << 31)) {
         last_error.code = MGA_ERR_OUT_OF_MEMORY;
-        last_error.msg = "Arena ran out of memory";
-        arena->_last_error = last_error;
-        arena->error_callback(last_error);
-        return NULL;
+        last_error.msg = "Intern table is too large";
+        table->_arena->_last_error = last_error;
+        table->_arena->error_callback(last_error);
+        return MGA_FALSE;
     }
 
-    _mga_malloc_node* node = arena->_malloc_backend.cur_node;
+    mga_u32 capacity = table->_capacity * 2;
+    mga_interned** slots = MGA_PUSH_ZERO_ARRAY(table->_arena, mga_interned*, capacity);
+    if (slots == NULL) {
+        return MGA_FALSE;
+    }
 
-    mga_u64 pos_aligned = MGA_ALIGN_UP_POW2(node->pos, arena->_align);
-    mga_u32 diff = pos_aligned - node->pos;
-    arena->_pos += diff + size;
-
-    if (arena->_pos >= node->size) {
-        
-        mga_u64 unclamped_node_size = MGA_ALIGN_UP_POW2(size, arena->_block_size);
-        mga_u64 max_node_size = arena->_size - arena->_pos;
-        mga_u64 node_size = MGA_MIN(unclamped_node_size, max_node_size);
-        
-        _mga_malloc_node* new_node = (_mga_malloc_node*)malloc(sizeof(_mga_malloc_node));
-        mga_u8* data = (mga_u8*)malloc(node_size);
-
-        if (new_node == NULL || data == NULL) {
-            if (new_node != NULL) { free(new_node); }
-            if (data != NULL) { free(data); }
-            
-            last_error.code = MGA_ERR_MALLOC_FAILED;
-            last_error.msg = "Failed to malloc new node";
-            arena->_last_error = last_error;
-            arena->error_callback(last_error);
+    mga_interned** old_slots = table->_slots;
+    mga_u32 old_capacity = table->_capacity;
+
+    table->_slots = slots;
+    table->_capacity = capacity;
+
+    for (mga_u32 i = 0; i < old_capacity; i++) {
+        mga_interned* entry = old_slots[i];
+        if (entry != NULL) {
+            *_mga_intern_lookup(table, entry->str, entry->hash) = entry;
+        }
+    }
+
+    return MGA_TRUE;
+}
+
+const mga_interned* mga_intern(mga_intern_table* table, mga_str8 str) {
+    mga_u64 hash = mga_str8_hash(str);
+    mga_interned** slot = _mga_intern_lookup(table, str, hash);
+
+    if (*slot != NULL) {
+        return *slot;
+    }
+
+    // Kept at most half full, so probe sequences stay short
+    if ((table->_count + 1) * 2 > table->_capacity) {
+        if (!_mga_intern_grow(table)) {
             return NULL;
         }
 
-        new_node->pos = size;
-        new_node->size = node_size;
-        new_node->data = data;
-        
-        new_node->prev = node;
-        arena->_malloc_backend.cur_node = new_node;
+        slot = _mga_intern_lookup(table, str, hash);
+    }
 
-        return (void*)(new_node->data);
+    // The string is stored right after its entry. The arena alignment can be
+    // lower than the alignment of the entry, so it is pushed with its own
+    mga_interned* entry = (mga_interned*)mga_push_aligned(
+        table->_arena, sizeof(mga_interned) + str.size, MGA_ALIGNOF(mga_interned)
+    );
+    if (entry == NULL) {
+        return NULL;
     }
-    
-    void* out = (void*)((mga_u8*)node->data + pos_aligned);
-    node->pos = pos_aligned + size;
 
-    return out;
+    entry->str = _mga_str8(str.size, (mga_u8*)(entry + 1));
+    entry->hash = hash;
+    if (str.size != 0) {
+        MGA_MEMCPY(entry->str.str, str.str, str.size);
+    }
+
+    *slot = entry;
+    table->_count++;
+
+    return entry;
+}
+const mga_interned* mga_intern_find(mga_intern_table* table, mga_str8 str) {
+    return *_mga_intern_lookup(table, str, mga_str8_hash(str));
 }
+mga_u32 mga_intern_table_count(mga_intern_table* table) { return table->_count; }
 
-void mga_pop(mg_arena* arena, mga_u64 size) {
-    if (size > arena->_pos) {
-        last_error.code = MGA_ERR_CANNOT_POP_MORE;
-        last_error.msg = "Attempted to pop too much memory";
+/*
+Files
+=======================
+  ___ ___ _    ___ ___ 
+ | __|_ _| |  | __/ __|
+ | _| | || |__| _|\__ \
+ |_| |___|____|___|___/
+
+=======================
+*/
+
+static void _mga_file_error(mg_arena* arena, const char* msg) {
+    last_error.code = MGA_ERR_FILE_FAILED;
+    last_error.msg = msg;
+
+    if (arena != NULL) {
         arena->_last_error = last_error;
         arena->error_callback(last_error);
     }
-    
-    mga_u64 size_left = size;
-    _mga_malloc_node* node = arena->_malloc_backend.cur_node;
-
-    while (size_left > node->pos) {
-        size_left -= node->pos;
-        
-        _mga_malloc_node* temp = node;
-        node = node->prev;
+}
 
-        free(temp->data);
-        free(temp);
+// Reads up to size bytes at file_offset into buffer.
+// Returns the number of bytes read, which is less than size if the file ended early, or -1 on failure
+static mga_i64 _mga_file_read_all(mga_i64 file, mga_u8* buffer, mga_u64 size, mga_u64 file_offset) {
+    mga_u64 offset = 0;
+    mga_i64 bytes_read = 0;
+
+#ifdef _MGA_IO_URING
+    // Small files are not worth the setup of a ring
+    if (size >= MGA_IO_URING_CHUNK * 2) {
+        mga_i64 async_read = _mga_file_read_async(file, buffer, size, file_offset);
+        if (async_read >= 0) {
+            offset = (mga_u64)async_read;
+        }
     }
+#endif
 
-    arena->_malloc_backend.cur_node = node;
+    // After io_uring, this only runs if the file got smaller while it was read
+    while (offset < size) {
+        bytes_read = _mga_file_read(file, buffer + offset, size - offset, file_offset + offset);
+        if (bytes_read <= 0) {
+            break;
+        }
+
+        offset += (mga_u64)bytes_read;
+    }
 
-    node->pos -= size_left;
-    arena->_pos -= size;
+    return bytes_read == -1 ? -1 : (mga_i64)offset;
 }
 
-void mga_reset(mg_arena* arena) {
-    mga_pop_to(arena, 0);
+mga_str8 mga_read_file(mg_arena* arena, const char* path) {
+    mga_u64 size = 0;
+    mga_i64 file = _mga_file_open(path, &size);
+    if (file == -1) {
+        _mga_file_error(arena, "Failed to open file");
+        return _mga_str8(0, NULL);
+    }
+
+    mga_u8* data = (mga_u8*)mga_push(arena, size);
+    if (data == NULL) {
+        _mga_file_close(file);
+        return _mga_str8(0, NULL);
+    }
+
+    // The file is read directly into the arena, so the
+    // only copy is the one out of the page cache
+    mga_i64 bytes_read = _mga_file_read_all(file, data, size, 0);
+
+    _mga_file_close(file);
+
+    if (bytes_read == -1) {
+        mga_pop(arena, size);
+        _mga_file_error(arena, "Failed to read file");
+        return _mga_str8(0, NULL);
+    }
+
+    // The file got smaller while it was read
+    if ((mga_u64)bytes_read < size) {
+        mga_pop(arena, size - (mga_u64)bytes_read);
+    }
+
+    return _mga_str8((mga_u64)bytes_read, data);
 }
 
-#else // MGA_FORCE_MALLOC
+mga_b32 mga_read_file_chunks(mg_arena* arena, const char* path, mga_u64 chunk_size, mga_file_chunk_func* func, void* user_data) {
+    mga_u64 size = 0;
+    mga_i64 file = _mga_file_open(path, &size);
+    if (file == -1) {
+        _mga_file_error(arena, "Failed to open file");
+        return MGA_FALSE;
+    }
 
-/*
-Low Level Backend
-================================================================================
-  _    _____      __  _    _____   _____ _      ___   _   ___ _  _____ _  _ ___  
- | |  / _ \ \    / / | |  | __\ \ / / __| |    | _ ) /_\ / __| |/ / __| \| |   \
- | |_| (_) \ \/\/ /  | |__| _| \ V /| _|| |__  | _ \/ _ \ (__| ' <| _|| .` | |) |
- |____\___/ \_/\_/   |____|___| \_/ |___|____| |___/_/ \_\___|_|\_\___|_|\_|___/ 
+    chunk_size = MGA_MIN(chunk_size == 0 ? MGA_MiB(1) : chunk_size, MGA_MAX(size, 1));
 
-================================================================================
-*/
+    mga_temp temp = mga_temp_begin(arena);
+    mga_u8* buffer = (mga_u8*)mga_push(arena, chunk_size);
+    if (buffer == NULL) {
+        _mga_file_close(file);
+        return MGA_FALSE;
+    }
 
-#define MGA_MIN_POS MGA_ALIGN_UP_POW2(sizeof(mg_arena), 64) 
+    // Reads until the end of the file, even if it grows
+    mga_u64 offset = 0;
+    mga_i64 bytes_read = 0;
+    for (;;) {
+        bytes_read = _mga_file_read(file, buffer, chunk_size, offset);
+        if (bytes_read <= 0 || !func(user_data, buffer, (mga_u64)bytes_read)) {
+            break;
+        }
 
-mg_arena* mga_create(const mga_desc* desc) {
-    _mga_init_data init_data = _mga_init_common(desc);
-    
-    mg_arena* out = MGA_MEM_RESERVE(init_data.max_size);
+        offset += (mga_u64)bytes_read;
+    }
 
-    if (out == NULL) {
-        last_error.code = MGA_ERR_INIT_FAILED;
-        last_error.msg = "Failed to reserve initial memory for arena";
-        init_data.error_callback(last_error);
-        return NULL;
+    _mga_file_close(file);
+    mga_temp_end(temp);
+
+    if (bytes_read == -1) {
+        _mga_file_error(arena, "Failed to read file");
+        return MGA_FALSE;
     }
 
-    if (!MGA_MEM_COMMIT(out, init_data.block_size)) {
-        last_error.code = MGA_ERR_INIT_FAILED;
-        last_error.msg = "Failed to commit initial memory for arena";
-        init_data.error_callback(last_error);
-        return NULL;
+    return MGA_TRUE;
+}
+
+mga_file_view mga_file_view_open(const char* path) {
+    mga_file_view out = MGA_ZERO_INIT;
+    mga_u64 size = 0;
+    mga_i64 file = _mga_file_open(path, &size);
+    if (file == -1) {
+        _mga_file_error(NULL, "Failed to open file");
+        return out;
     }
 
-    out->_pos = MGA_MIN_POS;
-    out->_size = init_data.max_size;
-    out->_block_size = init_data.block_size;
-    out->_align = init_data.align;
-    out->_reserve_backend.commit_pos = init_data.block_size;
-    out->_last_error = (mga_error){ .code=MGA_ERR_NONE, .msg="" };
-    out->error_callback = init_data.error_callback;
+    // Empty files cannot be mapped
+    if (size == 0) {
+        _mga_file_close(file);
+        return out;
+    }
+
+    void* handle = NULL;
+    void* data = _mga_file_map(file, size, &handle);
+
+    // The mapping keeps the file open
+    _mga_file_close(file);
+
+    if (data == NULL) {
+        _mga_file_error(NULL, "Failed to map file");
+        return out;
+    }
+
+    out.size = size;
+    out.data = (const mga_u8*)data;
+    out._handle = handle;
 
     return out;
 }
-void mga_destroy(mg_arena* arena) {
-    MGA_MEM_RELEASE(arena, arena->_size);
-}
-
-void* mga_push(mg_arena* arena, mga_u64 size) {
-    if (arena->_pos + size > arena->_size) {
-        last_error.code = MGA_ERR_OUT_OF_MEMORY;
-        last_error.msg = "Arena ran out of memory";
-        arena->_last_error = last_error;
-        arena->error_callback(last_error);
-        return NULL;
+void mga_file_view_close(mga_file_view* view) {
+    if (view->data != NULL) {
+        _mga_file_unmap((void*)view->data, view->size, view->_handle);
     }
 
-    mga_u64 pos_aligned = MGA_ALIGN_UP_POW2(arena->_pos, arena->_align);
-    void* out = (void*)((mga_u8*)arena + pos_aligned);
-    arena->_pos = pos_aligned + size;
+    view->size = 0;
+    view->data = NULL;
+    view->_handle = NULL;
+}
 
-    mga_u64 commit_pos = arena->_reserve_backend.commit_pos;
-    if (arena->_pos > commit_pos) {
-        mga_u64 commit_unclamped = MGA_ALIGN_UP_POW2(arena->_pos, arena->_block_size);
-        mga_u64 new_commit_pos = MGA_MIN(commit_unclamped, arena->_size);
-        mga_u64 commit_size = new_commit_pos - commit_pos;
-        
-        if (!MGA_MEM_COMMIT((void*)((mga_u8*)arena + commit_pos), commit_size)) {
-            last_error.code = MGA_ERR_COMMIT_FAILED;
-            last_error.msg = "Failed to commit memory";
-            arena->_last_error = last_error;
-            arena->error_callback(last_error);
-            return NULL;
+#define _MGA_SAVE_MAGIC 0x5341474d // "MGAS"
+
+// The data starts at MGA_CACHE_LINE + align_offset in the file,
+// so it keeps its alignment in file views too
+typedef struct {
+    mga_u32 magic;
+    // Offset of the data from the last MGA_CACHE_LINE boundary in the saved arena.
+    // Malloc and buffer arenas do not start on a cache line
+    mga_u32 align_offset;
+    mga_u64 size;
+} _mga_save_header;
+
+static mga_b32 _mga_file_write_all(mga_i64 file, const mga_u8* data, mga_u64 size) {
+    mga_u64 offset = 0;
+    while (offset < size) {
+        mga_i64 bytes_written = _mga_file_write(file, data + offset, size - offset);
+        if (bytes_written <= 0) {
+            return MGA_FALSE;
         }
 
-        arena->_reserve_backend.commit_pos = new_commit_pos;
+        offset += (mga_u64)bytes_written;
     }
 
-    return out;
+    return MGA_TRUE;
 }
 
-void mga_pop(mg_arena* arena, mga_u64 size) {
-    if (size > arena->_pos - MGA_MIN_POS) {
-        last_error.code = MGA_ERR_CANNOT_POP_MORE;
-        last_error.msg = "Attempted to pop too much memory";
+mga_b32 mga_save(mg_arena* arena, const char* path) {
+    if (arena->_backend == _MGA_BACKEND_MALLOC && arena->_malloc_backend.cur_node->prev != NULL) {
+        last_error.code = MGA_ERR_UNSUPPORTED;
+        last_error.msg = "Cannot save malloc arena with more than one node";
         arena->_last_error = last_error;
         arena->error_callback(last_error);
+        return MGA_FALSE;
+    }
 
-        return;
+    // The used memory is written as it is, relative pointers do not need any encoding
+    const mga_u8* data = arena->_fast_base + arena->_start_pos;
+
+    _mga_save_header header;
+    header.magic = _MGA_SAVE_MAGIC;
+    header.align_offset = (mga_u32)((uintptr_t)data & (MGA_CACHE_LINE - 1));
+    header.size = arena->_pos - arena->_start_pos;
+
+    mga_u8 prefix[MGA_CACHE_LINE * 2];
+    MGA_MEMSET(prefix, 0, sizeof(prefix));
+    MGA_MEMCPY(prefix, &header, sizeof(header));
+
+    mga_i64 file = _mga_file_create(path);
+    if (file == -1) {
+        _mga_file_error(arena, "Failed to create file");
+        return MGA_FALSE;
     }
 
-    arena->_pos = MGA_MAX(MGA_MIN_POS, arena->_pos - size);
+    mga_b32 written = _mga_file_write_all(file, prefix, MGA_CACHE_LINE + header.align_offset) &&
+        _mga_file_write_all(file, data, header.size);
 
-    mga_u64 new_commit = MGA_MIN(arena->_size, MGA_ALIGN_UP_POW2(arena->_pos, arena->_block_size));
-    mga_u64 commit_pos = arena->_reserve_backend.commit_pos;
+    _mga_file_close(file);
 
-    if (new_commit < commit_pos) {
-        mga_u64 decommit_size = commit_pos - new_commit;
-        MGA_MEM_DECOMMIT((void*)((mga_u8*)arena + new_commit), decommit_size);
-        arena->_reserve_backend.commit_pos = new_commit;
+    if (!written) {
+        _mga_file_error(arena, "Failed to write file");
+        return MGA_FALSE;
     }
-}
 
-void mga_reset(mg_arena* arena) {
-    mga_pop_to(arena, MGA_MIN_POS);
+    return MGA_TRUE;
 }
+void* mga_load(mg_arena* arena, const char* path, mga_u64* size) {
+    if (size != NULL) {
+        *size = 0;
+    }
 
-#endif // NOT MGA_FORCE_MALLOC
+    mga_u64 file_size = 0;
+    mga_i64 file = _mga_file_open(path, &file_size);
+    if (file == -1) {
+        _mga_file_error(arena, "Failed to open file");
+        return NULL;
+    }
 
-/*
-All Backends
-=========================================================
-    _   _    _      ___   _   ___ _  _____ _  _ ___  ___ 
-   /_\ | |  | |    | _ ) /_\ / __| |/ / __| \| |   \/ __|
-  / _ \| |__| |__  | _ \/ _ \ (__| ' <| _|| .` | |) \__ \
- /_/ \_\____|____| |___/_/ \_\___|_|\_\___|_|\_|___/|___/
+    _mga_save_header header;
+    mga_u64 data_offset = 0;
+    if (_mga_file_read_all(file, (mga_u8*)&header, sizeof(header), 0) == (mga_i64)sizeof(header) &&
+        header.magic == _MGA_SAVE_MAGIC && header.align_offset < MGA_CACHE_LINE) {
+        data_offset = MGA_CACHE_LINE + header.align_offset;
+    }
 
-=========================================================
-*/
+    if (data_offset == 0 || file_size < data_offset || header.size != file_size - data_offset) {
+        _mga_file_close(file);
+        _mga_file_error(arena, "Invalid save file");
+        return NULL;
+    }
 
+    // Same offset from a cache line as in the saved arena, so
+    // everything in the data keeps its alignment up to MGA_CACHE_LINE
+    mga_u64 push_size = header.align_offset + header.size;
+    mga_u8* data = (mga_u8*)mga_push_aligned(arena, push_size, MGA_CACHE_LINE);
+    if (data == NULL) {
+        _mga_file_close(file);
+        return NULL;
+    }
+    data += header.align_offset;
 
-mga_error mga_get_error(mg_arena* arena) {
-    mga_error* err = arena == NULL ? &last_error : &arena->_last_error;
-    mga_error temp = *err;
+    mga_i64 bytes_read = _mga_file_read_all(file, data, header.size, data_offset);
 
-    *err = (mga_error){ MGA_ERR_NONE, "" };
-    
-    return temp;
-}
+    _mga_file_close(file);
 
-mga_u64 mga_get_pos(mg_arena* arena) { return arena->_pos; }
-mga_u64 mga_get_size(mg_arena* arena) { return arena->_size; }
-mga_u32 mga_get_block_size(mg_arena* arena) { return arena->_block_size; }
-mga_u32 mga_get_align(mg_arena* arena) { return arena->_align; }
+    if (bytes_read != (mga_i64)header.size) {
+        mga_pop(arena, push_size);
+        _mga_file_error(arena, "Failed to read file");
+        return NULL;
+    }
 
-void* mga_push_zero(mg_arena* arena, mga_u64 size) {
-    mga_u8* out = mga_push(arena, size);
-    MGA_MEMSET(out, 0, size);
-    
-    return (void*)out;
+    if (size != NULL) {
+        *size = header.size;
+    }
+
+    return (void*)data;
 }
 
-void mga_pop_to(mg_arena* arena, mga_u64 pos) {
-    mga_pop(arena, arena->_pos - pos);
+/*
+Timelines
+=============================================
+  _____ ___ __  __ ___ _    ___ _  _ ___ ___ 
+ |_   _|_ _|  \/  | __| |  |_ _| \| | __/ __|
+   | |  | || |\/| | _|| |__ | || .` | _|\__ \
+   |_| |___|_|  |_|___|____|___|_|\_|___|___/
+
+=============================================
+*/
+
+mga_timeline* mga_timeline_create(mg_arena* storage, mg_arena* arena, mga_str8 name) {
+    // Samples taken during a commit would commit more memory
+    if (storage == arena) {
+        last_error.code = MGA_ERR_INIT_FAILED;
+        last_error.msg = "Timeline cannot be stored in the arena it records";
+        arena->_last_error = last_error;
+        arena->error_callback(last_error);
+        return NULL;
+    }
+
+    mga_timeline* out = MGA_PUSH_STRUCT(storage, mga_timeline);
+    mga_u8* name_copy = (mga_u8*)mga_push_copy(storage, name.str, name.size);
+    mga_bucket_array* samples = MGA_BUCKET_ARRAY_CREATE(storage, mga_sample, 256);
+
+    if (out == NULL || name_copy == NULL || samples == NULL) {
+        return NULL;
+    }
+
+    out->name = _mga_str8(name.size, name_copy);
+    out->samples = samples;
+    out->_arena = arena;
+    out->_start_time = _mga_time_ns();
+
+    arena->_timeline = out;
+    mga_timeline_sample(out);
+
+    return out;
 }
+void mga_timeline_sample(mga_timeline* timeline) {
+    mg_arena* arena = timeline->_arena;
+    if (arena == NULL) {
+        return;
+    }
 
-mga_temp mga_temp_begin(mg_arena* arena) {
-    return (mga_temp){
-        .arena = arena,
-        ._pos = arena->_pos
-    };
+    mga_sample sample;
+    sample.time = _mga_time_ns() - timeline->_start_time;
+    sample.pos = arena->_pos;
+    sample.committed = mga_get_committed(arena);
+
+    mga_bucket_array_push(timeline->samples, &sample);
 }
-void mga_temp_end(mga_temp temp) {
-    mga_pop_to(temp.arena, temp._pos);
+void mga_timeline_stop(mga_timeline* timeline) {
+    if (timeline->_arena != NULL && timeline->_arena->_timeline == timeline) {
+        timeline->_arena->_timeline = NULL;
+    }
+
+    timeline->_arena = NULL;
 }
 
-#ifndef MGA_SCRATCH_COUNT
-#   define MGA_SCRATCH_COUNT 2
-#endif
+/*
+Sorting
+====================================
+  ___  ___  ___ _____ ___ _  _  ___ 
+ / __|/ _ \| _ \_   _|_ _| \| |/ __|
+ \__ \ (_) |   / | |  | || .` | (_ |
+ |___/\___/|_|_\ |_| |___|_|\_|\___|
+
+====================================
+*/
 
-#ifndef MGA_NO_STDIO
-static void _mga_scratch_on_error(mga_error err) {
-    fprintf(stderr, "MGA Scratch Error %u: %s\n", err.code, err.msg);
-}
-#endif
+enum {
+    _MGA_RADIX_U32,
+    _MGA_RADIX_I32,
+    _MGA_RADIX_F32
+};
 
-static MGA_THREAD_VAR mga_desc _mga_scratch_desc = {
-    .desired_max_size = MGA_MiB(64),
-    .desired_block_size = MGA_KiB(256),
-#ifndef MGA_NO_STDIO
-    .error_callback = _mga_scratch_on_error,
+// Keys can be floats, so they are only accessed through fixed size copies
+// instead of mga_u32 pointers. Compilers turn these into plain loads and stores
+#if defined(__GNUC__) || defined(__clang__)
+#   define _MGA_COPY_U32(dst, src) __builtin_memcpy((dst), (src), sizeof(mga_u32))
+#else
+#   define _MGA_COPY_U32(dst, src) MGA_MEMCPY((dst), (src), sizeof(mga_u32))
 #endif
-};
-static MGA_THREAD_VAR mg_arena* _mga_scratch_arenas[MGA_SCRATCH_COUNT] = { 0 };
 
-void mga_scratch_set_desc(const mga_desc* desc) {
-    if (_mga_scratch_arenas[0] == NULL) {
-        _mga_scratch_desc = (mga_desc){
-            .desired_max_size = desc->desired_max_size,
-            .desired_block_size = desc->desired_block_size,
-            .align = desc->align,
-            .error_callback = desc->error_callback
-        };
+static mga_u32 _mga_radix_load(const void* keys, mga_u64 i) {
+    mga_u32 key;
+    _MGA_COPY_U32(&key, (const mga_u8*)keys + i * sizeof(mga_u32));
+    return key;
+}
+static void _mga_radix_store(void* keys, mga_u64 i, mga_u32 key) {
+    _MGA_COPY_U32((mga_u8*)keys + i * sizeof(mga_u32), &key);
+}
+
+// Maps keys to unsigned integers with the same order
+static mga_u32 _mga_radix_key_in(mga_u32 key, mga_u32 type) {
+    switch (type) {
+        case _MGA_RADIX_I32: return key ^ 0x80000000;
+        // Negative floats have every bit flipped, so larger magnitudes come first
+        case _MGA_RADIX_F32: return key ^ ((mga_u32)(-(mga_i32)(key >> 31)) | 0x80000000);
+        default: return key;
     }
 }
-mga_temp mga_scratch_get(mg_arena** conflicts, mga_u32 num_conflicts) {
-    if (_mga_scratch_arenas[0] == NULL) {
-        for (mga_u32 i = 0; i < MGA_SCRATCH_COUNT; i++) {
-            _mga_scratch_arenas[i] = mga_create(&_mga_scratch_desc);
-        }
+static mga_u32 _mga_radix_key_out(mga_u32 key, mga_u32 type) {
+    switch (type) {
+        case _MGA_RADIX_I32: return key ^ 0x80000000;
+        case _MGA_RADIX_F32: return key ^ (((key >> 31) - 1) | 0x80000000);
+        default: return key;
     }
+}
 
-    mga_temp out = { 0 };
+static mga_b32 _mga_radix_sort32(void* keys, mga_u32* values, mga_u64 count, mga_u32 type) {
+    if (count < 2) {
+        return MGA_TRUE;
+    }
 
-    for (mga_u32 i = 0; i < MGA_SCRATCH_COUNT; i++) {
-        mg_arena* arena = _mga_scratch_arenas[i];
+    mga_temp scratch = mga_scratch_get(NULL, 0);
 
-        mga_b32 in_conflict = MGA_FALSE;
-        for (mga_u32 j = 0; j < num_conflicts; j++) {
-            if (arena == conflicts[j]) {
-                in_conflict = MGA_TRUE;
-                break;
+    mga_u64* counts = MGA_PUSH_ZERO_ARRAY(scratch.arena, mga_u64, 4 * 256);
+    mga_u32* temp_keys = MGA_PUSH_ARRAY(scratch.arena, mga_u32, count);
+    mga_u32* temp_values = values == NULL ? NULL : MGA_PUSH_ARRAY(scratch.arena, mga_u32, count);
+
+    if (counts == NULL || temp_keys == NULL || (values != NULL && temp_values == NULL)) {
+        mga_scratch_release(scratch);
+        return MGA_FALSE;
+    }
+
+    // The histograms of all four digits are built in one pass
+    for (mga_u64 i = 0; i < count; i++) {
+        mga_u32 key = _mga_radix_key_in(_mga_radix_load(keys, i), type);
+        _mga_radix_store(keys, i, key);
+
+        counts[0 * 256 + (key & 0xff)]++;
+        counts[1 * 256 + ((key >> 8) & 0xff)]++;
+        counts[2 * 256 + ((key >> 16) & 0xff)]++;
+        counts[3 * 256 + (key >> 24)]++;
+    }
+
+    void* src_keys = keys;
+    void* dst_keys = temp_keys;
+    mga_u32* src_values = values;
+    mga_u32* dst_values = temp_values;
+
+    for (mga_u32 pass = 0; pass < 4; pass++) {
+        mga_u32 shift = pass * 8;
+        mga_u64* offsets = counts + pass * 256;
+
+        // Every key has the same digit, so the pass would not move anything
+        if (offsets[(_mga_radix_load(src_keys, 0) >> shift) & 0xff] == count) {
+            continue;
+        }
+
+        mga_u64 total = 0;
+        for (mga_u32 i = 0; i < 256; i++) {
+            mga_u64 digit_count = offsets[i];
+            offsets[i] = total;
+            total += digit_count;
+        }
+
+        for (mga_u64 i = 0; i < count; i++) {
+            mga_u32 key = _mga_radix_load(src_keys, i);
+            mga_u64 dst = offsets[(key >> shift) & 0xff]++;
+
+            _mga_radix_store(dst_keys, dst, key);
+            if (values != NULL) {
+                dst_values[dst] = src_values[i];
             }
         }
-        if (in_conflict) { continue; }
 
-        out = mga_temp_begin(arena);
+        void* swap_keys = src_keys;
+        src_keys = dst_keys;
+        dst_keys = swap_keys;
+
+        mga_u32* swap_values = src_values;
+        src_values = dst_values;
+        dst_values = swap_values;
     }
 
-    return out;
+    if (src_keys != keys) {
+        MGA_MEMCPY(keys, src_keys, sizeof(mga_u32) * count);
+        if (values != NULL) {
+            MGA_MEMCPY(values, src_values, sizeof(mga_u32) * count);
+        }
+    }
+
+    if (type != _MGA_RADIX_U32) {
+        for (mga_u64 i = 0; i < count; i++) {
+            _mga_radix_store(keys, i, _mga_radix_key_out(_mga_radix_load(keys, i), type));
+        }
+    }
+
+    mga_scratch_release(scratch);
+
+    return MGA_TRUE;
 }
-void mga_scratch_release(mga_temp scratch) {
-    mga_temp_end(scratch);
+
+mga_b32 mga_radix_sort_u32(mga_u32* keys, mga_u32* values, mga_u64 count) {
+    return _mga_radix_sort32(keys, values, count, _MGA_RADIX_U32);
+}
+mga_b32 mga_radix_sort_i32(mga_i32* keys, mga_u32* values, mga_u64 count) {
+    return _mga_radix_sort32(keys, values, count, _MGA_RADIX_I32);
+}
+mga_b32 mga_radix_sort_f32(float* keys, mga_u32* values, mga_u64 count) {
+    return _mga_radix_sort32(keys, values, count, _MGA_RADIX_F32);
+}
+
+void mga_prefix_sum_u32(mga_u32* data, mga_u64 count) {
+    for (mga_u64 i = 1; i < count; i++) {
+        data[i] += data[i - 1];
+    }
+}
+void mga_prefix_sum_f32(float* data, mga_u64 count) {
+    for (mga_u64 i = 1; i < count; i++) {
+        data[i] += data[i - 1];
+    }
 }
 
 #ifdef __cplusplus
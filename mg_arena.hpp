@@ -0,0 +1,317 @@
+/*
+MGA CPP Header
+=================================================================
+  __  __  ___   _      ___ ___ ___   _  _ ___   _   ___  ___ ___ 
+ |  \/  |/ __| /_\    / __| _ \ _ \ | || | __| /_\ |   \| __| _ \
+ | |\/| | (_ |/ _ \  | (__|  _/  _/ | __ | _| / _ \| |) | _||   /
+ |_|  |_|\___/_/ \_\  \___|_| |_|   |_||_|___/_/ \_\___/|___|_|_\
+
+=================================================================
+*/
+
+#ifndef MG_ARENA_HPP
+#define MG_ARENA_HPP
+
+#ifndef MG_ARENA_H
+#   error "mg_arena.h required by mg_arena.hpp"
+#endif
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <new>
+#include <initializer_list>
+#include <type_traits>
+#include <utility>
+
+#if defined(_MSVC_LANG)
+#   define MGA_CPP_VERSION _MSVC_LANG
+#else
+#   define MGA_CPP_VERSION __cplusplus
+#endif
+
+#if MGA_CPP_VERSION >= 201703L && !defined(MGA_NO_PMR)
+#   if defined(__has_include)
+#       if __has_include(<memory_resource>)
+#           include <memory_resource>
+#           define MGA_HAS_PMR
+#       endif
+#   endif
+#endif
+
+#if defined(__cpp_exceptions) || defined(_CPPUNWIND)
+#   define MGA_THROW_BAD_ALLOC() throw std::bad_alloc()
+#   define MGA_THROW_BAD_ARRAY_LENGTH() throw std::bad_array_new_length()
+#else
+#   include <cstdlib>
+#   define MGA_THROW_BAD_ALLOC() std::abort()
+#   define MGA_THROW_BAD_ARRAY_LENGTH() std::abort()
+#endif
+
+namespace mga {
+
+namespace detail {
+
+inline void* push_aligned(mg_arena* arena, std::size_t size, std::size_t align) {
+    return mga_push_aligned(arena, size, (mga_u32)align);
+}
+
+} // namespace detail
+
+/*
+Memory Resource
+===========================================================================
+  __  __ ___ __  __  ___  _____   __  ___ ___ ___  ___  _   _ ___  ___ ___ 
+ |  \/  | __|  \/  |/ _ \| _ \ \ / / | _ \ __/ __|/ _ \| | | | _ \/ __| __|
+ | |\/| | _|| |\/| | (_) |   /\ V /  |   / _|\__ \ (_) | |_| |   / (__| _| 
+ |_|  |_|___|_|  |_|\___/|_|_\ |_|   |_|_\___|___/\___/ \___/|_|_\\___|___|
+
+===========================================================================
+*/
+
+#ifdef MGA_HAS_PMR
+
+// Memory is only freed when the arena is popped, like std::pmr::monotonic_buffer_resource
+class memory_resource final : public std::pmr::memory_resource {
+public:
+    explicit memory_resource(mg_arena* arena) noexcept : _arena(arena) { }
+
+    mg_arena* arena() const noexcept { return _arena; }
+
+private:
+    mg_arena* _arena;
+
+    void* do_allocate(std::size_t bytes, std::size_t alignment) override {
+        void* out = detail::push_aligned(_arena, bytes, alignment);
+        if (out == nullptr) {
+            MGA_THROW_BAD_ALLOC();
+        }
+
+        return out;
+    }
+    void do_deallocate(void* ptr, std::size_t bytes, std::size_t alignment) override {
+        (void)ptr;
+        (void)bytes;
+        (void)alignment;
+    }
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+        return this == &other;
+    }
+};
+
+#endif // MGA_HAS_PMR
+
+/*
+Typed Push
+================================================
+  _______   _____ ___ ___    ___ _   _ ___ _  _ 
+ |_   _\ \ / / _ \ __|   \  | _ \ | | / __| || |
+   | |  \ V /|  _/ _|| |) | |  _/ |_| \__ \ __ |
+   |_|   |_| |_| |___|___/  |_|  \___/|___/_||_|
+
+================================================
+*/
+
+namespace detail {
+
+template <typename T>
+inline T* construct_n(T* ptr, std::size_t count) {
+    // Trivial types are left uninitialized, like mga_push
+    if (!std::is_trivially_default_constructible<T>::value && ptr != nullptr) {
+        for (std::size_t i = 0; i < count; i++) {
+            ::new ((void*)(ptr + i)) T();
+        }
+    }
+
+    return ptr;
+}
+
+} // namespace detail
+
+// Pushes count objects of type T, using alignof(T) instead of the arena alignment.
+// Types that are not trivially default constructible are value initialized.
+// Returns nullptr if the arena runs out of memory or the size overflows
+template <typename T>
+inline T* push(mg_arena* arena, std::size_t count = 1) {
+    if (count > SIZE_MAX / sizeof(T)) {
+        return nullptr;
+    }
+
+    T* out = (T*)detail::push_aligned(arena, sizeof(T) * count, alignof(T));
+    return detail::construct_n(out, count);
+}
+
+// Same as mga::push, but the size is computed at compile time
+template <typename T, std::size_t N>
+inline T* push(mg_arena* arena) {
+    static_assert(N <= SIZE_MAX / sizeof(T), "Size of push overflows");
+    constexpr std::size_t size = sizeof(T) * N;
+
+    T* out = (T*)detail::push_aligned(arena, size, alignof(T));
+    return detail::construct_n(out, N);
+}
+
+template <typename T>
+inline T* push_zero(mg_arena* arena, std::size_t count = 1) {
+    static_assert(std::is_trivially_default_constructible<T>::value, "mga::push_zero requires a trivial type");
+
+    T* out = push<T>(arena, count);
+    if (out != nullptr) {
+        std::memset(out, 0, sizeof(T) * count);
+    }
+
+    return out;
+}
+
+// Constructs one object in place with the given arguments
+template <typename T, typename... Args>
+inline T* emplace(mg_arena* arena, Args&&... args) {
+    void* out = detail::push_aligned(arena, sizeof(T), alignof(T));
+    if (out == nullptr) {
+        return nullptr;
+    }
+
+    return ::new (out) T(std::forward<Args>(args)...);
+}
+
+/*
+Allocator
+===============================================
+    _   _    _    ___   ___   _ _____ ___  ___ 
+   /_\ | |  | |  / _ \ / __| /_\_   _/ _ \| _ \
+  / _ \| |__| |_| (_) | (__ / _ \| || (_) |   /
+ /_/ \_\____|____\___/ \___/_/ \_\_| \___/|_|_\
+
+===============================================
+*/
+
+// Stateful allocator for STL containers. Deallocation does nothing
+template <typename T>
+class allocator {
+public:
+    using value_type = T;
+
+    using propagate_on_container_move_assignment = std::true_type;
+    using propagate_on_container_swap = std::true_type;
+
+    allocator(mg_arena* arena) noexcept : _arena(arena) { }
+
+    template <typename U>
+    allocator(const allocator<U>& other) noexcept : _arena(other.arena()) { }
+
+    mg_arena* arena() const noexcept { return _arena; }
+
+    T* allocate(std::size_t n) {
+        if (n > SIZE_MAX / sizeof(T)) {
+            MGA_THROW_BAD_ARRAY_LENGTH();
+        }
+
+        void* out = detail::push_aligned(_arena, n * sizeof(T), alignof(T));
+        if (out == nullptr) {
+            MGA_THROW_BAD_ALLOC();
+        }
+
+        return (T*)out;
+    }
+    void deallocate(T* ptr, std::size_t n) noexcept {
+        (void)ptr;
+        (void)n;
+    }
+
+private:
+    mg_arena* _arena;
+};
+
+template <typename T, typename U>
+inline bool operator==(const allocator<T>& a, const allocator<U>& b) noexcept {
+    return a.arena() == b.arena();
+}
+template <typename T, typename U>
+inline bool operator!=(const allocator<T>& a, const allocator<U>& b) noexcept {
+    return a.arena() != b.arena();
+}
+
+/*
+Scopes
+============================
+  ___  ___ ___  ___ ___ ___ 
+ / __|/ __/ _ \| _ \ __/ __|
+ \__ \ (_| (_) |  _/ _|\__ \
+ |___/\___\___/|_| |___|___/
+
+============================
+*/
+
+// Calls mga_temp_begin and mga_temp_end
+class temp_scope {
+public:
+    explicit temp_scope(mg_arena* arena) noexcept : _temp(mga_temp_begin(arena)) { }
+    ~temp_scope() { mga_temp_end(_temp); }
+
+    temp_scope(const temp_scope&) = delete;
+    temp_scope& operator=(const temp_scope&) = delete;
+
+    mg_arena* arena() const noexcept { return _temp.arena; }
+
+private:
+    mga_temp _temp;
+};
+
+// Calls mga_scratch_get and mga_scratch_release
+class scratch_scope {
+public:
+    explicit scratch_scope(mg_arena** conflicts = nullptr, mga_u32 num_conflicts = 0) noexcept
+        : _temp(mga_scratch_get(conflicts, num_conflicts)) { }
+    explicit scratch_scope(std::initializer_list<mg_arena*> conflicts) noexcept
+        : _temp(mga_scratch_get(const_cast<mg_arena**>(conflicts.begin()), (mga_u32)conflicts.size())) { }
+    ~scratch_scope() {
+        if (_temp.arena != nullptr) {
+            mga_scratch_release(_temp);
+        }
+    }
+
+    scratch_scope(const scratch_scope&) = delete;
+    scratch_scope& operator=(const scratch_scope&) = delete;
+
+    mg_arena* arena() const noexcept { return _temp.arena; }
+
+private:
+    mga_temp _temp;
+};
+
+} // namespace mga
+
+#endif // MG_ARENA_HPP
+
+/*
+License
+=================================
+  _    ___ ___ ___ _  _ ___ ___ 
+ | |  |_ _/ __| __| \| / __| __|
+ | |__ | | (__| _|| .` \__ \ _| 
+ |____|___\___|___|_|\_|___/___|
+                                
+=================================
+
+MIT License
+
+Copyright (c) 2023 Magicalbat
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
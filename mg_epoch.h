@@ -0,0 +1,296 @@
+/*
+MGE Header
+================================================
+  __  __  ___ ___   _  _ ___   _   ___  ___ ___ 
+ |  \/  |/ __| __| | || | __| /_\ |   \| __| _ \
+ | |\/| | (_ | _|  | __ | _| / _ \| |) | _||   /
+ |_|  |_|\___|___| |_||_|___/_/ \_\___/|___|_|_\
+
+================================================
+*/
+
+#ifndef MG_EPOCH_H
+#define MG_EPOCH_H
+
+#ifndef MG_ARENA_H
+#   error "mg_arena.h required by mg_epoch.h"
+#endif
+
+#ifndef MGE_FUNC_DEF
+#   if defined(MGE_STATIC)
+#      define MGE_FUNC_DEF static
+#   elif defined(_WIN32) && defined(MGE_DLL) && defined(MG_EPOCH_IMPL)
+#       define MGE_FUNC_DEF __declspec(dllexport)
+#   elif defined(_WIN32) && defined(MGE_DLL)
+#       define MGE_FUNC_DEF __declspec(dllimport)
+#   else
+#      define MGE_FUNC_DEF extern
+#   endif
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#ifndef MGE_CACHE_LINE
+#   define MGE_CACHE_LINE 64
+#endif
+
+// Memory allocated in epoch e is reused when the epoch advances to e + MGE_NUM_EPOCHS.
+// Because readers can still be pinned in the previous epoch, everything that is
+// reachable by readers has to be allocated in the current epoch before advancing.
+#define MGE_NUM_EPOCHS 3
+
+#define MGE_INVALID_READER ((mga_u32)-1)
+
+typedef struct {
+    mga_u64 epoch;
+    mga_u8 _pad[MGE_CACHE_LINE - sizeof(mga_u64)];
+} _mge_reader_slot;
+
+typedef struct {
+    mg_arena* _arenas[MGE_NUM_EPOCHS];
+
+    mga_u32 _max_readers;
+    _mge_reader_slot* _readers;
+
+    mga_u8 _pad0[MGE_CACHE_LINE];
+    mga_u64 _epoch;
+    mga_u8 _pad1[MGE_CACHE_LINE];
+} mge_domain;
+
+typedef struct {
+    mga_u32 max_readers;
+    mga_desc arena_desc;
+} mge_desc;
+
+MGE_FUNC_DEF mge_domain* mge_create(mg_arena* arena, const mge_desc* desc);
+MGE_FUNC_DEF void mge_destroy(mge_domain* domain);
+
+// Reader functions
+MGE_FUNC_DEF mga_u32 mge_reader_register(mge_domain* domain);
+MGE_FUNC_DEF void mge_reader_unregister(mge_domain* domain, mga_u32 reader);
+
+MGE_FUNC_DEF void mge_pin(mge_domain* domain, mga_u32 reader);
+MGE_FUNC_DEF void mge_unpin(mge_domain* domain, mga_u32 reader);
+
+// Writer functions
+MGE_FUNC_DEF mga_u64 mge_get_epoch(mge_domain* domain);
+MGE_FUNC_DEF mg_arena* mge_get_arena(mge_domain* domain);
+MGE_FUNC_DEF void* mge_copy(mge_domain* domain, const void* ptr, mga_u64 size);
+MGE_FUNC_DEF mga_b32 mge_try_advance(mge_domain* domain);
+
+// Publishing and reading shared pointers
+MGE_FUNC_DEF void mge_store_ptr(void** dst, void* ptr);
+MGE_FUNC_DEF void* mge_load_ptr(void** src);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // MG_EPOCH_H
+
+/*
+MGE Implementation
+========================================================================================
+  __  __  ___ ___   ___ __  __ ___ _    ___ __  __ ___ _  _ _____ _ _____ ___ ___  _  _ 
+ |  \/  |/ __| __| |_ _|  \/  | _ \ |  | __|  \/  | __| \| |_   _/_\_   _|_ _/ _ \| \| |
+ | |\/| | (_ | _|   | || |\/| |  _/ |__| _|| |\/| | _|| .` | | |/ _ \| |  | | (_) | .` |
+ |_|  |_|\___|___| |___|_|  |_|_| |____|___|_|  |_|___|_|\_| |_/_/ \_\_| |___\___/|_|\_|
+
+========================================================================================
+*/
+
+#ifdef MG_EPOCH_IMPL
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#if defined(_MSC_VER) && !defined(__clang__)
+#    include <intrin.h>
+#    define MGE_LOAD_ACQUIRE(p) ((mga_u64)_InterlockedOr64((volatile __int64*)(p), 0))
+#    define MGE_STORE_RELEASE(p, v) _InterlockedExchange64((volatile __int64*)(p), (__int64)(v))
+#    define MGE_LOAD_SEQ_CST(p) ((mga_u64)_InterlockedOr64((volatile __int64*)(p), 0))
+#    define MGE_STORE_SEQ_CST(p, v) _InterlockedExchange64((volatile __int64*)(p), (__int64)(v))
+// expected is a pointer to a local variable, like __atomic_compare_exchange_n
+#    define MGE_CAS(p, expected, desired) \
+        ((mga_u64)_InterlockedCompareExchange64((volatile __int64*)(p), (__int64)(desired), (__int64)*(expected)) == *(expected))
+#    define MGE_LOAD_PTR_ACQUIRE(p) ((void*)_InterlockedOr64((volatile __int64*)(p), 0))
+#    define MGE_STORE_PTR_RELEASE(p, v) _InterlockedExchange64((volatile __int64*)(p), (__int64)(v))
+#else
+#    define MGE_LOAD_ACQUIRE(p) __atomic_load_n((p), __ATOMIC_ACQUIRE)
+#    define MGE_STORE_RELEASE(p, v) __atomic_store_n((p), (v), __ATOMIC_RELEASE)
+#    define MGE_LOAD_SEQ_CST(p) __atomic_load_n((p), __ATOMIC_SEQ_CST)
+#    define MGE_STORE_SEQ_CST(p, v) __atomic_store_n((p), (v), __ATOMIC_SEQ_CST)
+#    define MGE_CAS(p, expected, desired) \
+        __atomic_compare_exchange_n((p), (expected), (desired), 0, __ATOMIC_ACQ_REL, __ATOMIC_RELAXED)
+#    define MGE_LOAD_PTR_ACQUIRE(p) __atomic_load_n((p), __ATOMIC_ACQUIRE)
+#    define MGE_STORE_PTR_RELEASE(p, v) __atomic_store_n((p), (v), __ATOMIC_RELEASE)
+#endif
+
+#define MGE_TRUE 1
+#define MGE_FALSE 0
+
+#ifndef MGE_MEMCPY
+#   include <string.h>
+#   define MGE_MEMCPY memcpy
+#endif
+
+// Value of a reader slot that is registered, but not pinned
+#define _MGE_UNPINNED ((mga_u64)-1)
+// Value of a reader slot that is free
+#define _MGE_FREE ((mga_u64)-2)
+
+mge_domain* mge_create(mg_arena* arena, const mge_desc* desc) {
+    mga_u32 max_readers = desc->max_readers == 0 ? 64 : desc->max_readers;
+
+    mge_domain* domain = MGA_PUSH_ZERO_STRUCT(arena, mge_domain);
+    _mge_reader_slot* readers = MGA_PUSH_ZERO_ARRAY(arena, _mge_reader_slot, max_readers);
+    if (domain == NULL || readers == NULL) {
+        return NULL;
+    }
+
+    for (mga_u32 i = 0; i < max_readers; i++) {
+        readers[i].epoch = _MGE_FREE;
+    }
+
+    for (mga_u32 i = 0; i < MGE_NUM_EPOCHS; i++) {
+        domain->_arenas[i] = mga_create(&desc->arena_desc);
+
+        if (domain->_arenas[i] == NULL) {
+            for (mga_u32 j = 0; j < i; j++) {
+                mga_destroy(domain->_arenas[j]);
+            }
+            return NULL;
+        }
+    }
+
+    domain->_max_readers = max_readers;
+    domain->_readers = readers;
+    domain->_epoch = 0;
+
+    return domain;
+}
+
+void mge_destroy(mge_domain* domain) {
+    for (mga_u32 i = 0; i < MGE_NUM_EPOCHS; i++) {
+        mga_destroy(domain->_arenas[i]);
+    }
+}
+
+mga_u32 mge_reader_register(mge_domain* domain) {
+    for (mga_u32 i = 0; i < domain->_max_readers; i++) {
+        mga_u64 expected = _MGE_FREE;
+        if (MGE_CAS(&domain->_readers[i].epoch, &expected, _MGE_UNPINNED)) {
+            return i;
+        }
+    }
+
+    return MGE_INVALID_READER;
+}
+void mge_reader_unregister(mge_domain* domain, mga_u32 reader) {
+    MGE_STORE_RELEASE(&domain->_readers[reader].epoch, _MGE_FREE);
+}
+
+void mge_pin(mge_domain* domain, mga_u32 reader) {
+    mga_u64* slot = &domain->_readers[reader].epoch;
+
+    // The epoch has to be checked again after publishing it,
+    // in case a writer advanced the epoch without seeing the reader
+    mga_u64 epoch = MGE_LOAD_ACQUIRE(&domain->_epoch);
+    while (1) {
+        MGE_STORE_SEQ_CST(slot, epoch);
+
+        mga_u64 new_epoch = MGE_LOAD_SEQ_CST(&domain->_epoch);
+        if (new_epoch == epoch) {
+            break;
+        }
+        epoch = new_epoch;
+    }
+}
+void mge_unpin(mge_domain* domain, mga_u32 reader) {
+    MGE_STORE_RELEASE(&domain->_readers[reader].epoch, _MGE_UNPINNED);
+}
+
+mga_u64 mge_get_epoch(mge_domain* domain) {
+    return MGE_LOAD_ACQUIRE(&domain->_epoch);
+}
+mg_arena* mge_get_arena(mge_domain* domain) {
+    return domain->_arenas[domain->_epoch % MGE_NUM_EPOCHS];
+}
+
+void* mge_copy(mge_domain* domain, const void* ptr, mga_u64 size) {
+    void* out = mga_push(mge_get_arena(domain), size);
+    if (out != NULL) {
+        MGE_MEMCPY(out, ptr, size);
+    }
+
+    return out;
+}
+
+mga_b32 mge_try_advance(mge_domain* domain) {
+    mga_u64 epoch = domain->_epoch;
+
+    for (mga_u32 i = 0; i < domain->_max_readers; i++) {
+        mga_u64 reader_epoch = MGE_LOAD_SEQ_CST(&domain->_readers[i].epoch);
+
+        if (reader_epoch != _MGE_FREE && reader_epoch != _MGE_UNPINNED && reader_epoch != epoch) {
+            return MGE_FALSE;
+        }
+    }
+
+    // Every pinned reader is in the current epoch, so nothing
+    // can still reference memory from two epochs ago
+    mga_reset(domain->_arenas[(epoch + 1) % MGE_NUM_EPOCHS]);
+
+    MGE_STORE_SEQ_CST(&domain->_epoch, epoch + 1);
+
+    return MGE_TRUE;
+}
+
+void mge_store_ptr(void** dst, void* ptr) {
+    MGE_STORE_PTR_RELEASE(dst, ptr);
+}
+void* mge_load_ptr(void** src) {
+    return MGE_LOAD_PTR_ACQUIRE(src);
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // MG_EPOCH_IMPL
+
+/*
+License
+=================================
+  _    ___ ___ ___ _  _ ___ ___ 
+ | |  |_ _/ __| __| \| / __| __|
+ | |__ | | (__| _|| .` \__ \ _| 
+ |____|___\___|___|_|\_|___/___|
+                                
+=================================
+
+MIT License
+
+Copyright (c) 2023 Magicalbat
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
@@ -0,0 +1,1063 @@
+/*
+MGJ Header
+=================================================
+  __  __  ___    _   _  _ ___   _   ___  ___ ___ 
+ |  \/  |/ __|_ | | | || | __| /_\ |   \| __| _ \
+ | |\/| | (_ | || | | __ | _| / _ \| |) | _||   /
+ |_|  |_|\___|\__/  |_||_|___/_/ \_\___/|___|_|_\
+
+=================================================
+*/
+
+#ifndef MG_JOBS_H
+#define MG_JOBS_H
+
+#ifndef MG_ARENA_H
+#   error "mg_arena.h required by mg_jobs.h"
+#endif
+
+#ifndef MGJ_FUNC_DEF
+#   if defined(MGJ_STATIC)
+#      define MGJ_FUNC_DEF static
+#   elif defined(_WIN32) && defined(MGJ_DLL) && defined(MG_JOBS_IMPL)
+#       define MGJ_FUNC_DEF __declspec(dllexport)
+#   elif defined(_WIN32) && defined(MGJ_DLL)
+#       define MGJ_FUNC_DEF __declspec(dllimport)
+#   else
+#      define MGJ_FUNC_DEF extern
+#   endif
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// scratch is a scratch arena of the thread running the task.
+// Everything pushed onto it is released when the task returns.
+typedef void (mgj_task_func)(void* arg, mg_arena* scratch);
+typedef void (mgj_for_func)(void* arg, mga_u64 start, mga_u64 end, mg_arena* scratch);
+
+typedef struct mgj_pool mgj_pool;
+
+typedef struct {
+    mga_u64 _pending;
+} mgj_group;
+
+typedef struct {
+    mga_u32 num_threads;
+    mga_u32 queue_size;
+    mga_desc scratch_desc;
+} mgj_desc;
+
+MGJ_FUNC_DEF mgj_pool* mgj_create(mg_arena* arena, const mgj_desc* desc);
+MGJ_FUNC_DEF void mgj_destroy(mgj_pool* pool);
+
+MGJ_FUNC_DEF mga_u32 mgj_get_num_threads(mgj_pool* pool);
+MGJ_FUNC_DEF mga_u32 mgj_get_thread_index(mgj_pool* pool);
+
+MGJ_FUNC_DEF void mgj_run(mgj_pool* pool, mgj_group* group, mgj_task_func* func, void* arg);
+MGJ_FUNC_DEF void mgj_wait(mgj_pool* pool, mgj_group* group);
+
+MGJ_FUNC_DEF void mgj_parallel_for(mgj_pool* pool, mga_u64 count, mga_u64 batch_size, mgj_for_func* func, void* arg);
+
+// Multi-threaded versions of the mga_radix_sort functions, with the same results.
+// The temporary buffers come from the scratch arenas of the calling thread
+MGJ_FUNC_DEF mga_b32 mgj_radix_sort_u32(mgj_pool* pool, mga_u32* keys, mga_u32* values, mga_u64 count);
+MGJ_FUNC_DEF mga_b32 mgj_radix_sort_i32(mgj_pool* pool, mga_i32* keys, mga_u32* values, mga_u64 count);
+MGJ_FUNC_DEF mga_b32 mgj_radix_sort_f32(mgj_pool* pool, float* keys, mga_u32* values, mga_u64 count);
+
+// Multi-threaded inclusive prefix sums, in place
+MGJ_FUNC_DEF void mgj_prefix_sum_u32(mgj_pool* pool, mga_u32* data, mga_u64 count);
+MGJ_FUNC_DEF void mgj_prefix_sum_f32(mgj_pool* pool, float* data, mga_u64 count);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // MG_JOBS_H
+
+/*
+MGJ Implementation
+=========================================================================================
+  __  __  ___    _   ___ __  __ ___ _    ___ __  __ ___ _  _ _____ _ _____ ___ ___  _  _ 
+ |  \/  |/ __|_ | | |_ _|  \/  | _ \ |  | __|  \/  | __| \| |_   _/_\_   _|_ _/ _ \| \| |
+ | |\/| | (_ | || |  | || |\/| |  _/ |__| _|| |\/| | _|| .` | | |/ _ \| |  | | (_) | .` |
+ |_|  |_|\___|\__/  |___|_|  |_|_| |____|___|_|  |_|___|_|\_| |_/_/ \_\_| |___\___/|_|\_|
+
+=========================================================================================
+*/
+
+#ifdef MG_JOBS_IMPL
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#if defined(_WIN32)
+#    define MGJ_PLATFORM_WIN32
+#elif defined(__linux__) || defined(__APPLE__) || defined(__EMSCRIPTEN__) || defined(__unix__)
+#    define MGJ_PLATFORM_POSIX
+#else
+#    error "MG JOBS: Unsupported platform"
+#endif
+
+#include <string.h>
+
+#ifndef MGJ_CACHE_LINE
+#   define MGJ_CACHE_LINE 64
+#endif
+
+#ifndef MGJ_MAX_THREADS
+#   define MGJ_MAX_THREADS 64
+#endif
+
+// Smaller inputs are sorted and scanned on the calling thread
+#ifndef MGJ_MIN_BLOCK_SIZE
+#   define MGJ_MIN_BLOCK_SIZE 16384
+#endif
+
+#define MGJ_TRUE 1
+#define MGJ_FALSE 0
+
+#define MGJ_UNUSED(x) (void)(x)
+#define MGJ_MIN(a, b) ((a) < (b) ? (a) : (b))
+
+#ifndef MGJ_THREAD_VAR
+#    if defined(__clang__) || defined(__GNUC__)
+#        define MGJ_THREAD_VAR __thread
+#    elif defined(_MSC_VER)
+#        define MGJ_THREAD_VAR __declspec(thread)
+#    elif (__STDC_VERSION__ >= 201112L)
+#        define MGJ_THREAD_VAR _Thread_local
+#    else
+#        error "MG JOBS: Invalid compiler/version for thead variable; Define MGJ_THREAD_VAR, use Clang, GCC, or MSVC, or use C11 or greater"
+#    endif
+#endif
+
+/*
+Threads
+====================================
+  _____ _  _ ___ ___   _   ___  ___ 
+ |_   _| || | _ \ __| /_\ |   \/ __|
+   | | | __ |   / _| / _ \| |) \__ \
+   |_| |_||_|_|_\___/_/ \_\___/|___/
+
+====================================
+*/
+
+#ifdef MGJ_PLATFORM_WIN32
+
+#ifndef UNICODE
+    #define UNICODE
+#endif
+#define WIN32_LEAN_AND_MEAN
+
+#include <Windows.h>
+#include <intrin.h>
+
+#define MGJ_LOAD_RELAXED(p) (*(volatile mga_u64*)(p))
+#define MGJ_LOAD_ACQUIRE(p) ((mga_u64)_InterlockedOr64((volatile __int64*)(p), 0))
+#define MGJ_STORE_RELAXED(p, v) (*(volatile mga_u64*)(p) = (mga_u64)(v))
+#define MGJ_STORE_RELEASE(p, v) _InterlockedExchange64((volatile __int64*)(p), (__int64)(v))
+#define MGJ_FETCH_ADD(p, v) ((mga_u64)_InterlockedExchangeAdd64((volatile __int64*)(p), (__int64)(v)))
+// expected is a pointer to a local variable, like __atomic_compare_exchange_n
+#define MGJ_CAS(p, expected, desired) \
+    ((mga_u64)_InterlockedCompareExchange64((volatile __int64*)(p), (__int64)(desired), (__int64)*(expected)) == *(expected))
+#define MGJ_FENCE() MemoryBarrier()
+
+#define MGJ_LOAD_PTR(p) (*(void* volatile*)(p))
+#define MGJ_STORE_PTR(p, v) (*(void* volatile*)(p) = (void*)(v))
+// Function pointers can not be converted to void* in ISO C
+#define MGJ_LOAD_FUNC(p) (*(mgj_task_func* volatile*)(p))
+#define MGJ_STORE_FUNC(p, v) (*(mgj_task_func* volatile*)(p) = (v))
+
+typedef HANDLE _mgj_thread;
+typedef CRITICAL_SECTION _mgj_mutex;
+typedef struct {
+    CRITICAL_SECTION mutex;
+    CONDITION_VARIABLE cond;
+} _mgj_signal;
+
+typedef DWORD (WINAPI _mgj_thread_func)(LPVOID);
+#define MGJ_THREAD_FUNC(name, arg) static DWORD WINAPI name(LPVOID arg)
+#define MGJ_THREAD_RETURN return 0
+
+static mga_b32 _mgj_thread_create(_mgj_thread* thread, _mgj_thread_func* func, void* arg) {
+    *thread = CreateThread(NULL, 0, func, arg, 0, NULL);
+    return *thread != NULL;
+}
+static void _mgj_thread_join(_mgj_thread thread) {
+    WaitForSingleObject(thread, INFINITE);
+    CloseHandle(thread);
+}
+static void _mgj_thread_yield(void) {
+    SwitchToThread();
+}
+static mga_u32 _mgj_num_cpus(void) {
+    SYSTEM_INFO si;
+    GetSystemInfo(&si);
+    return (mga_u32)si.dwNumberOfProcessors;
+}
+
+static void _mgj_mutex_init(_mgj_mutex* mutex) { InitializeCriticalSection(mutex); }
+static void _mgj_mutex_destroy(_mgj_mutex* mutex) { DeleteCriticalSection(mutex); }
+static void _mgj_mutex_lock(_mgj_mutex* mutex) { EnterCriticalSection(mutex); }
+static void _mgj_mutex_unlock(_mgj_mutex* mutex) { LeaveCriticalSection(mutex); }
+
+static void _mgj_signal_init(_mgj_signal* signal) {
+    InitializeCriticalSection(&signal->mutex);
+    InitializeConditionVariable(&signal->cond);
+}
+static void _mgj_signal_destroy(_mgj_signal* signal) {
+    DeleteCriticalSection(&signal->mutex);
+}
+static void _mgj_signal_lock(_mgj_signal* signal) { EnterCriticalSection(&signal->mutex); }
+static void _mgj_signal_unlock(_mgj_signal* signal) { LeaveCriticalSection(&signal->mutex); }
+static void _mgj_signal_wait(_mgj_signal* signal) {
+    SleepConditionVariableCS(&signal->cond, &signal->mutex, INFINITE);
+}
+static void _mgj_signal_wake_one(_mgj_signal* signal) { WakeConditionVariable(&signal->cond); }
+static void _mgj_signal_wake_all(_mgj_signal* signal) { WakeAllConditionVariable(&signal->cond); }
+
+#endif // MGJ_PLATFORM_WIN32
+
+#ifdef MGJ_PLATFORM_POSIX
+
+#include <pthread.h>
+#include <sched.h>
+#include <unistd.h>
+
+#define MGJ_LOAD_RELAXED(p) __atomic_load_n((p), __ATOMIC_RELAXED)
+#define MGJ_LOAD_ACQUIRE(p) __atomic_load_n((p), __ATOMIC_ACQUIRE)
+#define MGJ_STORE_RELAXED(p, v) __atomic_store_n((p), (v), __ATOMIC_RELAXED)
+#define MGJ_STORE_RELEASE(p, v) __atomic_store_n((p), (v), __ATOMIC_RELEASE)
+#define MGJ_FETCH_ADD(p, v) __atomic_fetch_add((p), (v), __ATOMIC_SEQ_CST)
+#define MGJ_CAS(p, expected, desired) \
+    __atomic_compare_exchange_n((p), (expected), (desired), 0, __ATOMIC_SEQ_CST, __ATOMIC_RELAXED)
+#define MGJ_FENCE() __atomic_thread_fence(__ATOMIC_SEQ_CST)
+
+#define MGJ_LOAD_PTR(p) __atomic_load_n((p), __ATOMIC_RELAXED)
+#define MGJ_STORE_PTR(p, v) __atomic_store_n((p), (v), __ATOMIC_RELAXED)
+#define MGJ_LOAD_FUNC(p) __atomic_load_n((p), __ATOMIC_RELAXED)
+#define MGJ_STORE_FUNC(p, v) __atomic_store_n((p), (v), __ATOMIC_RELAXED)
+
+typedef pthread_t _mgj_thread;
+typedef pthread_mutex_t _mgj_mutex;
+typedef struct {
+    pthread_mutex_t mutex;
+    pthread_cond_t cond;
+} _mgj_signal;
+
+typedef void* (_mgj_thread_func)(void*);
+#define MGJ_THREAD_FUNC(name, arg) static void* name(void* arg)
+#define MGJ_THREAD_RETURN return NULL
+
+static mga_b32 _mgj_thread_create(_mgj_thread* thread, _mgj_thread_func* func, void* arg) {
+    return pthread_create(thread, NULL, func, arg) == 0;
+}
+static void _mgj_thread_join(_mgj_thread thread) {
+    pthread_join(thread, NULL);
+}
+static void _mgj_thread_yield(void) {
+    sched_yield();
+}
+static mga_u32 _mgj_num_cpus(void) {
+    long num = sysconf(_SC_NPROCESSORS_ONLN);
+    return num < 1 ? 1 : (mga_u32)num;
+}
+
+static void _mgj_mutex_init(_mgj_mutex* mutex) { pthread_mutex_init(mutex, NULL); }
+static void _mgj_mutex_destroy(_mgj_mutex* mutex) { pthread_mutex_destroy(mutex); }
+static void _mgj_mutex_lock(_mgj_mutex* mutex) { pthread_mutex_lock(mutex); }
+static void _mgj_mutex_unlock(_mgj_mutex* mutex) { pthread_mutex_unlock(mutex); }
+
+static void _mgj_signal_init(_mgj_signal* signal) {
+    pthread_mutex_init(&signal->mutex, NULL);
+    pthread_cond_init(&signal->cond, NULL);
+}
+static void _mgj_signal_destroy(_mgj_signal* signal) {
+    pthread_cond_destroy(&signal->cond);
+    pthread_mutex_destroy(&signal->mutex);
+}
+static void _mgj_signal_lock(_mgj_signal* signal) { pthread_mutex_lock(&signal->mutex); }
+static void _mgj_signal_unlock(_mgj_signal* signal) { pthread_mutex_unlock(&signal->mutex); }
+static void _mgj_signal_wait(_mgj_signal* signal) {
+    pthread_cond_wait(&signal->cond, &signal->mutex);
+}
+static void _mgj_signal_wake_one(_mgj_signal* signal) { pthread_cond_signal(&signal->cond); }
+static void _mgj_signal_wake_all(_mgj_signal* signal) { pthread_cond_broadcast(&signal->cond); }
+
+#endif // MGJ_PLATFORM_POSIX
+
+/*
+Deques
+==============================
+  ___  ___ ___  _   _ ___ ___ 
+ |   \| __/ _ \| | | | __/ __|
+ | |) | _| (_) | |_| | _|\__ \
+ |___/|___\__\_\\___/|___|___/
+
+==============================
+*/
+
+// Chase-Lev work stealing deque, with a fixed size buffer
+// (Based on "Correct and Efficient Work-Stealing for Weak Memory Models", Le et al. 2013)
+// The owner pushes and takes from the bottom, other threads steal from the top.
+
+typedef struct {
+    mgj_task_func* func;
+    void* arg;
+    mgj_group* group;
+} _mgj_task;
+
+typedef struct {
+    _mgj_task* tasks;
+    mga_u64 mask;
+
+    mga_u8 _pad0[MGJ_CACHE_LINE];
+    mga_u64 top;
+    mga_u8 _pad1[MGJ_CACHE_LINE];
+    mga_u64 bottom;
+    mga_u8 _pad2[MGJ_CACHE_LINE];
+} _mgj_deque;
+
+// Thieves can read a slot while the owner overwrites it (the following CAS fails then),
+// so the fields are accessed atomically
+static void _mgj_task_store(_mgj_task* slot, _mgj_task task) {
+    MGJ_STORE_FUNC(&slot->func, task.func);
+    MGJ_STORE_PTR(&slot->arg, task.arg);
+    MGJ_STORE_PTR((void**)&slot->group, (void*)task.group);
+}
+static _mgj_task _mgj_task_load(_mgj_task* slot) {
+    _mgj_task task;
+    task.func = MGJ_LOAD_FUNC(&slot->func);
+    task.arg = MGJ_LOAD_PTR(&slot->arg);
+    task.group = (mgj_group*)MGJ_LOAD_PTR((void**)&slot->group);
+
+    return task;
+}
+
+static mga_b32 _mgj_deque_push(_mgj_deque* deque, _mgj_task task) {
+    mga_u64 bottom = MGJ_LOAD_RELAXED(&deque->bottom);
+    mga_u64 top = MGJ_LOAD_ACQUIRE(&deque->top);
+
+    if (bottom - top > deque->mask) {
+        return MGJ_FALSE;
+    }
+
+    _mgj_task_store(&deque->tasks[bottom & deque->mask], task);
+    MGJ_STORE_RELEASE(&deque->bottom, bottom + 1);
+
+    return MGJ_TRUE;
+}
+
+static mga_b32 _mgj_deque_take(_mgj_deque* deque, _mgj_task* out) {
+    mga_u64 bottom = MGJ_LOAD_RELAXED(&deque->bottom) - 1;
+    MGJ_STORE_RELAXED(&deque->bottom, bottom);
+    MGJ_FENCE();
+    mga_u64 top = MGJ_LOAD_RELAXED(&deque->top);
+
+    if ((mga_i64)(bottom - top) < 0) {
+        MGJ_STORE_RELAXED(&deque->bottom, bottom + 1);
+        return MGJ_FALSE;
+    }
+
+    *out = _mgj_task_load(&deque->tasks[bottom & deque->mask]);
+
+    if (bottom != top) {
+        return MGJ_TRUE;
+    }
+
+    // Last task, race against thieves
+    mga_u64 expected = top;
+    mga_b32 won = MGJ_CAS(&deque->top, &expected, top + 1);
+    MGJ_STORE_RELAXED(&deque->bottom, bottom + 1);
+
+    return won;
+}
+
+static mga_b32 _mgj_deque_steal(_mgj_deque* deque, _mgj_task* out) {
+    mga_u64 top = MGJ_LOAD_ACQUIRE(&deque->top);
+    MGJ_FENCE();
+    mga_u64 bottom = MGJ_LOAD_ACQUIRE(&deque->bottom);
+
+    if ((mga_i64)(bottom - top) <= 0) {
+        return MGJ_FALSE;
+    }
+
+    *out = _mgj_task_load(&deque->tasks[top & deque->mask]);
+
+    mga_u64 expected = top;
+    return MGJ_CAS(&deque->top, &expected, top + 1);
+}
+
+// Tasks queued by threads outside of the pool. The deques only allow one
+// thread at the owner end, so these go through a locked ring instead
+typedef struct {
+    _mgj_task* tasks;
+    mga_u64 mask;
+    mga_u64 head;
+    mga_u64 tail;
+    // tail - head, so workers can skip the lock when the ring is empty
+    mga_u64 count;
+    _mgj_mutex mutex;
+} _mgj_inject;
+
+static mga_b32 _mgj_inject_push(_mgj_inject* inject, _mgj_task task) {
+    mga_b32 pushed = MGJ_FALSE;
+
+    _mgj_mutex_lock(&inject->mutex);
+    if (inject->tail - inject->head <= inject->mask) {
+        inject->tasks[inject->tail & inject->mask] = task;
+        inject->tail++;
+        MGJ_STORE_RELEASE(&inject->count, inject->tail - inject->head);
+        pushed = MGJ_TRUE;
+    }
+    _mgj_mutex_unlock(&inject->mutex);
+
+    return pushed;
+}
+static mga_b32 _mgj_inject_pop(_mgj_inject* inject, _mgj_task* out) {
+    if (MGJ_LOAD_ACQUIRE(&inject->count) == 0) {
+        return MGJ_FALSE;
+    }
+
+    mga_b32 popped = MGJ_FALSE;
+
+    _mgj_mutex_lock(&inject->mutex);
+    if (inject->head != inject->tail) {
+        *out = inject->tasks[inject->head & inject->mask];
+        inject->head++;
+        MGJ_STORE_RELEASE(&inject->count, inject->tail - inject->head);
+        popped = MGJ_TRUE;
+    }
+    _mgj_mutex_unlock(&inject->mutex);
+
+    return popped;
+}
+
+/*
+Jobs
+=====================
+     _  ___  ___ ___ 
+  _ | |/ _ \| _ ) __|
+ | || | (_) | _ \__ \
+  \__/ \___/|___/___/
+
+=====================
+*/
+
+typedef struct {
+    mgj_pool* pool;
+    mga_u32 index;
+    _mgj_thread thread;
+} _mgj_worker;
+
+struct mgj_pool {
+    // Thread 0 is the thread that created the pool.
+    // Only set after every thread has started
+    mga_u32 num_threads;
+    // Workers steal from every deque, even the deques of threads that failed to start.
+    // This never changes after the threads start
+    mga_u32 num_deques;
+    _mgj_worker* workers;
+    _mgj_deque* deques;
+
+    mga_desc scratch_desc;
+
+    mga_u8 _pad0[MGJ_CACHE_LINE];
+    mga_u64 running;
+    mga_u64 queued;
+    mga_u64 sleeping;
+    mga_u8 _pad1[MGJ_CACHE_LINE];
+
+    _mgj_inject inject;
+    _mgj_signal signal;
+};
+
+static MGJ_THREAD_VAR mgj_pool* _mgj_cur_pool = NULL;
+static MGJ_THREAD_VAR mga_u32 _mgj_cur_index = 0;
+
+static void _mgj_thread_init(mgj_pool* pool, mga_u32 index) {
+    _mgj_cur_pool = pool;
+    _mgj_cur_index = index;
+
+    // The thread that creates the pool keeps its own scratch config
+    if (index == 0) {
+        return;
+    }
+
+    // Create the scratch arenas before any task needs them
+    if (pool->scratch_desc.desired_max_size != 0) {
+        mga_scratch_set_desc(&pool->scratch_desc);
+    }
+    mga_scratch_release(mga_scratch_get(NULL, 0));
+}
+
+static mga_b32 _mgj_find_task(mgj_pool* pool, mga_u32 index, _mgj_task* out) {
+    if (_mgj_deque_take(&pool->deques[index], out)) {
+        return MGJ_TRUE;
+    }
+
+    if (_mgj_inject_pop(&pool->inject, out)) {
+        return MGJ_TRUE;
+    }
+
+    for (mga_u32 i = 1; i < pool->num_deques; i++) {
+        mga_u32 victim = (index + i) % pool->num_deques;
+        if (_mgj_deque_steal(&pool->deques[victim], out)) {
+            return MGJ_TRUE;
+        }
+    }
+
+    return MGJ_FALSE;
+}
+
+static void _mgj_execute(mgj_pool* pool, _mgj_task task) {
+    MGJ_FETCH_ADD(&pool->queued, (mga_u64)-1);
+
+    mga_temp scratch = mga_scratch_get(NULL, 0);
+    task.func(task.arg, scratch.arena);
+    mga_scratch_release(scratch);
+
+    if (task.group != NULL) {
+        MGJ_FETCH_ADD(&task.group->_pending, (mga_u64)-1);
+    }
+}
+
+MGJ_THREAD_FUNC(_mgj_worker_func, arg) {
+    _mgj_worker* worker = (_mgj_worker*)arg;
+    mgj_pool* pool = worker->pool;
+
+    _mgj_thread_init(pool, worker->index);
+
+    mga_u32 num_fails = 0;
+    while (MGJ_LOAD_ACQUIRE(&pool->running)) {
+        _mgj_task task;
+        if (_mgj_find_task(pool, worker->index, &task)) {
+            _mgj_execute(pool, task);
+            num_fails = 0;
+            continue;
+        }
+
+        if (++num_fails < 64) {
+            _mgj_thread_yield();
+            continue;
+        }
+
+        // Sleep until a task gets queued
+        _mgj_signal_lock(&pool->signal);
+        MGJ_FETCH_ADD(&pool->sleeping, 1);
+        while (MGJ_LOAD_ACQUIRE(&pool->queued) == 0 && MGJ_LOAD_ACQUIRE(&pool->running)) {
+            _mgj_signal_wait(&pool->signal);
+        }
+        MGJ_FETCH_ADD(&pool->sleeping, (mga_u64)-1);
+        _mgj_signal_unlock(&pool->signal);
+
+        num_fails = 0;
+    }
+
+    MGJ_THREAD_RETURN;
+}
+
+mgj_pool* mgj_create(mg_arena* arena, const mgj_desc* desc) {
+    mga_u32 num_threads = desc->num_threads == 0 ? _mgj_num_cpus() : desc->num_threads;
+    num_threads = MGJ_MIN(num_threads, MGJ_MAX_THREADS);
+
+    mga_u64 queue_size = 2;
+    while (queue_size < (desc->queue_size == 0 ? 1024 : desc->queue_size)) {
+        queue_size <<= 1;
+    }
+
+    mgj_pool* pool = MGA_PUSH_ZERO_STRUCT(arena, mgj_pool);
+    _mgj_worker* workers = MGA_PUSH_ZERO_ARRAY(arena, _mgj_worker, num_threads);
+    _mgj_deque* deques = MGA_PUSH_ZERO_ARRAY(arena, _mgj_deque, num_threads);
+    if (pool == NULL || workers == NULL || deques == NULL) {
+        return NULL;
+    }
+
+    for (mga_u32 i = 0; i < num_threads; i++) {
+        deques[i].tasks = MGA_PUSH_ZERO_ARRAY(arena, _mgj_task, queue_size);
+        deques[i].mask = queue_size - 1;
+        if (deques[i].tasks == NULL) {
+            return NULL;
+        }
+    }
+
+    pool->inject.tasks = MGA_PUSH_ZERO_ARRAY(arena, _mgj_task, queue_size);
+    pool->inject.mask = queue_size - 1;
+    if (pool->inject.tasks == NULL) {
+        return NULL;
+    }
+
+    pool->num_deques = num_threads;
+    pool->workers = workers;
+    pool->deques = deques;
+    pool->scratch_desc = desc->scratch_desc;
+    pool->running = MGJ_TRUE;
+
+    _mgj_mutex_init(&pool->inject.mutex);
+    _mgj_signal_init(&pool->signal);
+
+    _mgj_thread_init(pool, 0);
+
+    // Run with the threads that did start
+    mga_u32 num_started = 1;
+    for (; num_started < num_threads; num_started++) {
+        workers[num_started].pool = pool;
+        workers[num_started].index = num_started;
+
+        if (!_mgj_thread_create(&workers[num_started].thread, _mgj_worker_func, &workers[num_started])) {
+            break;
+        }
+    }
+
+    // Workers only read num_deques, and tasks see this
+    // because it is written before any task can be queued
+    pool->num_threads = num_started;
+
+    return pool;
+}
+
+void mgj_destroy(mgj_pool* pool) {
+    _mgj_signal_lock(&pool->signal);
+    MGJ_STORE_RELEASE(&pool->running, MGJ_FALSE);
+    _mgj_signal_wake_all(&pool->signal);
+    _mgj_signal_unlock(&pool->signal);
+
+    for (mga_u32 i = 1; i < pool->num_threads; i++) {
+        _mgj_thread_join(pool->workers[i].thread);
+    }
+
+    _mgj_signal_destroy(&pool->signal);
+    _mgj_mutex_destroy(&pool->inject.mutex);
+
+    _mgj_cur_pool = NULL;
+}
+
+mga_u32 mgj_get_num_threads(mgj_pool* pool) {
+    return pool->num_threads;
+}
+mga_u32 mgj_get_thread_index(mgj_pool* pool) {
+    return _mgj_cur_pool == pool ? _mgj_cur_index : 0;
+}
+
+void mgj_run(mgj_pool* pool, mgj_group* group, mgj_task_func* func, void* arg) {
+    _mgj_task task;
+    task.func = func;
+    task.arg = arg;
+    task.group = group;
+
+    if (group != NULL) {
+        MGJ_FETCH_ADD(&group->_pending, 1);
+    }
+    MGJ_FETCH_ADD(&pool->queued, 1);
+
+    if (_mgj_cur_pool != pool) {
+        // Threads outside of the pool do not run tasks, so they
+        // wait for the pool to make space instead
+        while (!_mgj_inject_push(&pool->inject, task)) {
+            _mgj_thread_yield();
+        }
+    } else if (!_mgj_deque_push(&pool->deques[_mgj_cur_index], task)) {
+        // The deque is full, so the task runs right away
+        _mgj_execute(pool, task);
+        return;
+    }
+
+    if (MGJ_LOAD_ACQUIRE(&pool->sleeping) > 0) {
+        _mgj_signal_lock(&pool->signal);
+        _mgj_signal_wake_one(&pool->signal);
+        _mgj_signal_unlock(&pool->signal);
+    }
+}
+
+void mgj_wait(mgj_pool* pool, mgj_group* group) {
+    // Threads outside of the pool have no deque, and tasks
+    // running on them would share thread index 0
+    if (_mgj_cur_pool != pool) {
+        while (MGJ_LOAD_ACQUIRE(&group->_pending) != 0) {
+            _mgj_thread_yield();
+        }
+        return;
+    }
+
+    mga_u32 index = _mgj_cur_index;
+
+    // Help with other tasks instead of blocking
+    while (MGJ_LOAD_ACQUIRE(&group->_pending) != 0) {
+        _mgj_task task;
+        if (_mgj_find_task(pool, index, &task)) {
+            _mgj_execute(pool, task);
+        } else {
+            _mgj_thread_yield();
+        }
+    }
+}
+
+typedef struct {
+    mgj_for_func* func;
+    void* arg;
+    mga_u64 start;
+    mga_u64 end;
+} _mgj_for_range;
+
+static void _mgj_for_task(void* arg, mg_arena* scratch) {
+    _mgj_for_range* range = (_mgj_for_range*)arg;
+    range->func(range->arg, range->start, range->end, scratch);
+}
+
+void mgj_parallel_for(mgj_pool* pool, mga_u64 count, mga_u64 batch_size, mgj_for_func* func, void* arg) {
+    if (count == 0) {
+        return;
+    }
+    if (batch_size == 0) {
+        // About four batches per thread, for load balancing
+        batch_size = (count + pool->num_threads * 4 - 1) / (pool->num_threads * 4);
+    }
+
+    mga_u64 num_batches = (count + batch_size - 1) / batch_size;
+
+    mga_temp scratch = mga_scratch_get(NULL, 0);
+    _mgj_for_range* ranges = MGA_PUSH_ARRAY(scratch.arena, _mgj_for_range, num_batches);
+
+    mgj_group group = { 0 };
+    for (mga_u64 i = 0; i < num_batches; i++) {
+        ranges[i].func = func;
+        ranges[i].arg = arg;
+        ranges[i].start = i * batch_size;
+        ranges[i].end = MGJ_MIN(count, (i + 1) * batch_size);
+        mgj_run(pool, &group, _mgj_for_task, &ranges[i]);
+    }
+
+    mgj_wait(pool, &group);
+
+    mga_scratch_release(scratch);
+}
+
+// Splits count elements into about four blocks per thread
+static mga_u64 _mgj_num_blocks(mgj_pool* pool, mga_u64 count, mga_u64* block_size) {
+    mga_u64 num_blocks = MGJ_MIN((mga_u64)pool->num_threads * 4, count / MGJ_MIN_BLOCK_SIZE);
+    if (num_blocks <= 1) {
+        return 1;
+    }
+
+    *block_size = (count + num_blocks - 1) / num_blocks;
+    return (count + *block_size - 1) / *block_size;
+}
+
+enum {
+    _MGJ_RADIX_U32,
+    _MGJ_RADIX_I32,
+    _MGJ_RADIX_F32
+};
+
+// Keys can be floats, so they are copied instead of read through mga_u32 pointers
+static mga_u32 _mgj_radix_load(const void* keys, mga_u64 i) {
+    mga_u32 key;
+    memcpy(&key, (const mga_u8*)keys + i * sizeof(mga_u32), sizeof(mga_u32));
+    return key;
+}
+static void _mgj_radix_store(void* keys, mga_u64 i, mga_u32 key) {
+    memcpy((mga_u8*)keys + i * sizeof(mga_u32), &key, sizeof(mga_u32));
+}
+
+typedef struct {
+    mga_u32 type;
+    mga_u32 shift;
+    mga_u64 count;
+    mga_u64 block_size;
+
+    void* src_keys;
+    void* dst_keys;
+    mga_u32* src_values;
+    mga_u32* dst_values;
+
+    // 256 counts per block, turned into offsets before the scatter
+    mga_u64* counts;
+} _mgj_radix_args;
+
+// Same key mapping as mg_arena.h, so the order matches mga_radix_sort
+static void _mgj_radix_keys_in(void* arg, mga_u64 start, mga_u64 end, mg_arena* scratch) {
+    MGJ_UNUSED(scratch);
+    _mgj_radix_args* args = (_mgj_radix_args*)arg;
+
+    for (mga_u64 i = start; i < end; i++) {
+        mga_u32 key = _mgj_radix_load(args->src_keys, i);
+        _mgj_radix_store(args->src_keys, i, args->type == _MGJ_RADIX_I32 ? key ^ 0x80000000 :
+            key ^ ((mga_u32)(-(mga_i32)(key >> 31)) | 0x80000000));
+    }
+}
+static void _mgj_radix_keys_out(void* arg, mga_u64 start, mga_u64 end, mg_arena* scratch) {
+    MGJ_UNUSED(scratch);
+    _mgj_radix_args* args = (_mgj_radix_args*)arg;
+
+    for (mga_u64 i = start; i < end; i++) {
+        mga_u32 key = _mgj_radix_load(args->src_keys, i);
+        _mgj_radix_store(args->src_keys, i, args->type == _MGJ_RADIX_I32 ? key ^ 0x80000000 :
+            key ^ (((key >> 31) - 1) | 0x80000000));
+    }
+}
+
+static void _mgj_radix_count(void* arg, mga_u64 start, mga_u64 end, mg_arena* scratch) {
+    MGJ_UNUSED(scratch);
+    _mgj_radix_args* args = (_mgj_radix_args*)arg;
+
+    for (mga_u64 block = start; block < end; block++) {
+        mga_u64* counts = args->counts + block * 256;
+        memset(counts, 0, sizeof(mga_u64) * 256);
+
+        mga_u64 block_end = MGJ_MIN(args->count, (block + 1) * args->block_size);
+        for (mga_u64 i = block * args->block_size; i < block_end; i++) {
+            counts[(_mgj_radix_load(args->src_keys, i) >> args->shift) & 0xff]++;
+        }
+    }
+}
+static void _mgj_radix_scatter(void* arg, mga_u64 start, mga_u64 end, mg_arena* scratch) {
+    MGJ_UNUSED(scratch);
+    _mgj_radix_args* args = (_mgj_radix_args*)arg;
+
+    for (mga_u64 block = start; block < end; block++) {
+        mga_u64* offsets = args->counts + block * 256;
+
+        mga_u64 block_end = MGJ_MIN(args->count, (block + 1) * args->block_size);
+        for (mga_u64 i = block * args->block_size; i < block_end; i++) {
+            mga_u32 key = _mgj_radix_load(args->src_keys, i);
+            mga_u64 dst = offsets[(key >> args->shift) & 0xff]++;
+
+            _mgj_radix_store(args->dst_keys, dst, key);
+            if (args->src_values != NULL) {
+                args->dst_values[dst] = args->src_values[i];
+            }
+        }
+    }
+}
+
+static mga_b32 _mgj_radix_sort32(mgj_pool* pool, void* keys, mga_u32* values, mga_u64 count, mga_u32 type) {
+    mga_u64 block_size = count;
+    mga_u64 num_blocks = _mgj_num_blocks(pool, count, &block_size);
+
+    if (num_blocks == 1) {
+        switch (type) {
+            case _MGJ_RADIX_I32: return mga_radix_sort_i32((mga_i32*)keys, values, count);
+            case _MGJ_RADIX_F32: return mga_radix_sort_f32((float*)keys, values, count);
+            default: return mga_radix_sort_u32((mga_u32*)keys, values, count);
+        }
+    }
+
+    mga_temp scratch = mga_scratch_get(NULL, 0);
+
+    _mgj_radix_args args;
+    args.type = type;
+    args.shift = 0;
+    args.count = count;
+    args.block_size = block_size;
+    args.src_keys = keys;
+    args.dst_keys = MGA_PUSH_ARRAY(scratch.arena, mga_u32, count);
+    args.src_values = values;
+    args.dst_values = values == NULL ? NULL : MGA_PUSH_ARRAY(scratch.arena, mga_u32, count);
+    args.counts = MGA_PUSH_ARRAY(scratch.arena, mga_u64, num_blocks * 256);
+
+    if (args.dst_keys == NULL || args.counts == NULL || (values != NULL && args.dst_values == NULL)) {
+        mga_scratch_release(scratch);
+        return MGJ_FALSE;
+    }
+
+    if (type != _MGJ_RADIX_U32) {
+        mgj_parallel_for(pool, count, block_size, _mgj_radix_keys_in, &args);
+    }
+
+    for (mga_u32 pass = 0; pass < 4; pass++) {
+        args.shift = pass * 8;
+
+        // Blocks are counted and scattered in parallel. The offsets are computed
+        // digit by digit, then block by block, which keeps the sort stable
+        mgj_parallel_for(pool, num_blocks, 1, _mgj_radix_count, &args);
+
+        mga_u64 first_digit = (_mgj_radix_load(args.src_keys, 0) >> args.shift) & 0xff;
+        mga_u64 first_digit_count = 0;
+        for (mga_u64 block = 0; block < num_blocks; block++) {
+            first_digit_count += args.counts[block * 256 + first_digit];
+        }
+
+        // Every key has the same digit, so the pass would not move anything
+        if (first_digit_count == count) {
+            continue;
+        }
+
+        mga_u64 total = 0;
+        for (mga_u32 digit = 0; digit < 256; digit++) {
+            for (mga_u64 block = 0; block < num_blocks; block++) {
+                mga_u64 digit_count = args.counts[block * 256 + digit];
+                args.counts[block * 256 + digit] = total;
+                total += digit_count;
+            }
+        }
+
+        mgj_parallel_for(pool, num_blocks, 1, _mgj_radix_scatter, &args);
+
+        void* swap_keys = args.src_keys;
+        args.src_keys = args.dst_keys;
+        args.dst_keys = swap_keys;
+
+        mga_u32* swap_values = args.src_values;
+        args.src_values = args.dst_values;
+        args.dst_values = swap_values;
+    }
+
+    if (args.src_keys != keys) {
+        memcpy(keys, args.src_keys, sizeof(mga_u32) * count);
+        if (values != NULL) {
+            memcpy(values, args.src_values, sizeof(mga_u32) * count);
+        }
+
+        args.src_keys = keys;
+    }
+
+    if (type != _MGJ_RADIX_U32) {
+        mgj_parallel_for(pool, count, block_size, _mgj_radix_keys_out, &args);
+    }
+
+    mga_scratch_release(scratch);
+
+    return MGJ_TRUE;
+}
+
+mga_b32 mgj_radix_sort_u32(mgj_pool* pool, mga_u32* keys, mga_u32* values, mga_u64 count) {
+    return _mgj_radix_sort32(pool, keys, values, count, _MGJ_RADIX_U32);
+}
+mga_b32 mgj_radix_sort_i32(mgj_pool* pool, mga_i32* keys, mga_u32* values, mga_u64 count) {
+    return _mgj_radix_sort32(pool, keys, values, count, _MGJ_RADIX_I32);
+}
+mga_b32 mgj_radix_sort_f32(mgj_pool* pool, float* keys, mga_u32* values, mga_u64 count) {
+    return _mgj_radix_sort32(pool, keys, values, count, _MGJ_RADIX_F32);
+}
+
+typedef struct {
+    mga_b32 is_f32;
+    void* data;
+    mga_u64 count;
+    mga_u64 block_size;
+} _mgj_scan_args;
+
+static void _mgj_scan_blocks(void* arg, mga_u64 start, mga_u64 end, mg_arena* scratch) {
+    MGJ_UNUSED(scratch);
+    _mgj_scan_args* args = (_mgj_scan_args*)arg;
+
+    for (mga_u64 block = start; block < end; block++) {
+        mga_u64 block_start = block * args->block_size;
+        mga_u64 block_count = MGJ_MIN(args->count, block_start + args->block_size) - block_start;
+
+        if (args->is_f32) {
+            mga_prefix_sum_f32((float*)args->data + block_start, block_count);
+        } else {
+            mga_prefix_sum_u32((mga_u32*)args->data + block_start, block_count);
+        }
+    }
+}
+static void _mgj_scan_add(void* arg, mga_u64 start, mga_u64 end, mg_arena* scratch) {
+    MGJ_UNUSED(scratch);
+    _mgj_scan_args* args = (_mgj_scan_args*)arg;
+
+    // Every block after the first gets the total of the blocks before it
+    for (mga_u64 block = start == 0 ? 1 : start; block < end; block++) {
+        mga_u64 block_start = block * args->block_size;
+        mga_u64 block_end = MGJ_MIN(args->count, block_start + args->block_size);
+
+        if (args->is_f32) {
+            float* data = (float*)args->data;
+            float offset = data[block_start - 1];
+            for (mga_u64 i = block_start; i < block_end - 1; i++) {
+                data[i] += offset;
+            }
+        } else {
+            mga_u32* data = (mga_u32*)args->data;
+            mga_u32 offset = data[block_start - 1];
+            for (mga_u64 i = block_start; i < block_end - 1; i++) {
+                data[i] += offset;
+            }
+        }
+    }
+}
+
+static void _mgj_prefix_sum(mgj_pool* pool, void* data, mga_u64 count, mga_b32 is_f32) {
+    mga_u64 block_size = count;
+    mga_u64 num_blocks = _mgj_num_blocks(pool, count, &block_size);
+
+    if (num_blocks == 1) {
+        if (is_f32) {
+            mga_prefix_sum_f32((float*)data, count);
+        } else {
+            mga_prefix_sum_u32((mga_u32*)data, count);
+        }
+        return;
+    }
+
+    _mgj_scan_args args;
+    args.is_f32 = is_f32;
+    args.data = data;
+    args.count = count;
+    args.block_size = block_size;
+
+    mgj_parallel_for(pool, num_blocks, 1, _mgj_scan_blocks, &args);
+
+    // The last element of each block is made the running total,
+    // which is what the blocks after it are offset by
+    for (mga_u64 block = 1; block < num_blocks; block++) {
+        mga_u64 last = MGJ_MIN(count, (block + 1) * block_size) - 1;
+
+        if (is_f32) {
+            ((float*)data)[last] += ((float*)data)[block * block_size - 1];
+        } else {
+            ((mga_u32*)data)[last] += ((mga_u32*)data)[block * block_size - 1];
+        }
+    }
+
+    mgj_parallel_for(pool, num_blocks, 1, _mgj_scan_add, &args);
+}
+
+void mgj_prefix_sum_u32(mgj_pool* pool, mga_u32* data, mga_u64 count) {
+    _mgj_prefix_sum(pool, data, count, MGJ_FALSE);
+}
+void mgj_prefix_sum_f32(mgj_pool* pool, float* data, mga_u64 count) {
+    _mgj_prefix_sum(pool, data, count, MGJ_TRUE);
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // MG_JOBS_IMPL
+
+/*
+License
+=================================
+  _    ___ ___ ___ _  _ ___ ___ 
+ | |  |_ _/ __| __| \| / __| __|
+ | |__ | | (__| _|| .` \__ \ _| 
+ |____|___\___|___|_|\_|___/___|
+                                
+=================================
+
+MIT License
+
+Copyright (c) 2023 Magicalbat
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
@@ -164,6 +164,12 @@ void mgp_quads_ex(mgp_u32 num_quads, mgp_quadf* quads, mgp_vec4f color, mgp_vec4
 #define mgp_rects(num_rects, rects) mgp_rects_ex(num_rects, rects, (mgp_vec4f){ 0 }, (void*)0, (mgp_string8){ 0 })
 #define mgp_quads(num_quads, quads) mgp_quads_ex(num_quads, quads, (mgp_vec4f){ 0 }, (void*)0, (mgp_string8){ 0 })
 
+#ifdef MG_ARENA_H
+// Plots the pos (solid) and committed bytes (dashed) of each timeline in KiB over milliseconds,
+// with a marker at the peak of the committed bytes
+void mgp_arena_timelines(mga_timeline** timelines, mgp_u32 num_timelines);
+#endif
+
 #endif // MGP_PLOT_H
 
 
@@ -209,10 +215,11 @@ void mgp_quads_ex(mgp_u32 num_quads, mgp_quadf* quads, mgp_vec4f color, mgp_vec4
 #define ABS(n) ((n) < 0 ? -(n) : (n))
 #define SIGN(n) ((n) < 0 ? -1 : 1)
 
-#define SLL_PUSH_BACK(f, l, n) ((f) == 0 ? \
-    ((f) = (l) = (n)) :                    \
-    ((l)->next = (n), (l) = (n)),          \
-    ((n)->next = 0))                       \
+// Goes through the draw commands bucket by bucket,
+// so the inner loop is over contiguous commands
+#define FOR_EACH_DRAW_CMD(cmd) \
+    for (mga_bucket* _bucket = mga_bucket_array_first(_mgp_draw_cmds); _bucket != NULL; _bucket = mga_bucket_next(_bucket)) \
+        for (mgp_draw_cmd* cmd = (mgp_draw_cmd*)_bucket->data; cmd < (mgp_draw_cmd*)_bucket->data + _bucket->count; cmd++)
 
 mgp_string8 _str8_from_range(mgp_u8* start, mgp_u8* end);
 mgp_string8 _str8_from_cstr(mgp_u8* cstr);
@@ -390,19 +397,14 @@ static const _font_glyph_data _font_glyphs_data[95];
 =============================
 */
 
-typedef struct _mgp_draw_cmd_node {
-    mgp_draw_cmd cmd;
-    struct _mgp_draw_cmd_node* next;
-} _mgp_draw_cmd_node;
-
-typedef struct {
-    mgp_u32 size;
-    _mgp_draw_cmd_node* first;
-    _mgp_draw_cmd_node* last;
-} _mgp_draw_cmd_list;
+// Draw commands are stored in buckets, so the passes over them
+// in mgp_plot_show read whole chunks of commands at once
+#define _MGP_CMDS_PER_BUCKET 64
 
 static mg_arena* _mgp_arena = NULL;
-static _mgp_draw_cmd_list _mgp_draw_cmds = { 0 };
+static mga_bucket_array* _mgp_draw_cmds = NULL;
+// Commands often share labels, so each label is only stored once
+static mga_intern_table* _mgp_labels = NULL;
 static mgp_u32 _mgp_default_win_width = 800;
 static mgp_u32 _mgp_default_win_height = 600;
 static mgp_u32 _mgp_win_width = 800;
@@ -454,54 +456,47 @@ void mgp_init(void) {
             .desired_block_size = MGA_KiB(64)
         };
         _mgp_arena = mga_create(&desc);
+        _mgp_draw_cmds = MGA_BUCKET_ARRAY_CREATE(_mgp_arena, mgp_draw_cmd, _MGP_CMDS_PER_BUCKET);
+        _mgp_labels = mga_intern_table_create(_mgp_arena, 0);
     }
 
     _mgp_colors = _mgp_default_colors;
 }
 void mgp_cmd_push(const mgp_draw_cmd* cmd) {
-    _mgp_draw_cmd_node* node = MGA_PUSH_ZERO_STRUCT(_mgp_arena, _mgp_draw_cmd_node);
-
-    memcpy(&node->cmd, cmd, sizeof(mgp_draw_cmd));
+    mgp_draw_cmd* out = MGA_BUCKET_ARRAY_PUSH(_mgp_draw_cmds, mgp_draw_cmd, cmd);
 
     if (cmd->colors != NULL) {
-        node->cmd.colors = MGA_PUSH_ARRAY(_mgp_arena, mgp_vec4f, cmd->size);
-        memcpy(node->cmd.colors, cmd->colors, sizeof(mgp_vec4f) * cmd->size);
+        out->colors = (mgp_vec4f*)mga_push_copy(_mgp_arena, cmd->colors, sizeof(mgp_vec4f) * cmd->size);
     }
 
     if (cmd->label.size != 0) {
-        node->cmd.label = _str8_copy(_mgp_arena, cmd->label);
+        const mga_interned* label = mga_intern(_mgp_labels, (mga_str8){ cmd->label.size, cmd->label.str });
+        out->label = label == NULL ? (mgp_string8){ 0 } : (mgp_string8){ label->str.size, label->str.str };
     }
 
-    mgp_vec4f col = node->cmd.color;
-    if (node->cmd.colors == NULL && (col.x == 0.0f && col.y == 0.0f  && col.z == 0.0f  && col.w == 0.0f)) {
-        node->cmd.color = _mgp_colors.default_draw[_mgp_draw_col_index++];
+    mgp_vec4f col = out->color;
+    if (out->colors == NULL && (col.x == 0.0f && col.y == 0.0f  && col.z == 0.0f  && col.w == 0.0f)) {
+        out->color = _mgp_colors.default_draw[_mgp_draw_col_index++];
         _mgp_draw_col_index %= sizeof(_mgp_colors.default_draw) / sizeof(_mgp_colors.default_draw[0]);
     }
 
-    switch(node->cmd.type) {
+    switch(out->type) {
         case MGP_DRAW_POINTS: {
-            node->cmd.points.data = MGA_PUSH_ARRAY(_mgp_arena, mgp_vec2f, cmd->size);
-            memcpy(node->cmd.points.data, cmd->points.data, sizeof(mgp_vec2f) * cmd->size);
+            out->points.data = (mgp_vec2f*)mga_push_copy(_mgp_arena, cmd->points.data, sizeof(mgp_vec2f) * cmd->size);
         } break;
         case MGP_DRAW_LINES: {
-            node->cmd.lines.data = MGA_PUSH_ARRAY(_mgp_arena, mgp_vec2f, cmd->size);
-            memcpy(node->cmd.lines.data, cmd->lines.data, sizeof(mgp_vec2f) * cmd->size);
+            out->lines.data = (mgp_vec2f*)mga_push_copy(_mgp_arena, cmd->lines.data, sizeof(mgp_vec2f) * cmd->size);
         } break;
         case MGP_DRAW_RECTS: {
-            node->cmd.rects.data = MGA_PUSH_ARRAY(_mgp_arena, mgp_rectf, cmd->size);
-            memcpy(node->cmd.rects.data, cmd->rects.data, sizeof(mgp_rectf) * cmd->size);
+            out->rects.data = (mgp_rectf*)mga_push_copy(_mgp_arena, cmd->rects.data, sizeof(mgp_rectf) * cmd->size);
         } break;
         case MGP_DRAW_QUADS: {
-            node->cmd.quads.data = MGA_PUSH_ARRAY(_mgp_arena, mgp_quadf, cmd->size);
-            memcpy(node->cmd.quads.data, cmd->quads.data, sizeof(mgp_quadf) * cmd->size);
+            out->quads.data = (mgp_quadf*)mga_push_copy(_mgp_arena, cmd->quads.data, sizeof(mgp_quadf) * cmd->size);
         } break;
         
         // TODO: Error handling
         default: break;
     }
-
-    _mgp_draw_cmds.size++;
-    SLL_PUSH_BACK(_mgp_draw_cmds.first, _mgp_draw_cmds.last, node);
 }
 // mgp_plot_show() is below
 
@@ -629,6 +624,73 @@ void mgp_quads_ex(mgp_u32 num_quads, mgp_quadf* quads, mgp_vec4f color, mgp_vec4
 
     mga_scratch_release(scratch);
 }
+void mgp_arena_timelines(mga_timeline** timelines, mgp_u32 num_timelines) {
+    mga_temp scratch = mga_scratch_get(NULL, 0);
+
+    for (mgp_u32 i = 0; i < num_timelines; i++) {
+        mga_timeline* timeline = timelines[i];
+        mgp_u32 num_samples = (mgp_u32)mga_bucket_array_count(timeline->samples);
+        if (num_samples == 0) {
+            continue;
+        }
+
+        mga_temp temp = mga_temp_begin(scratch.arena);
+
+        mgp_f32* xs = MGA_PUSH_ARRAY(temp.arena, mgp_f32, num_samples);
+        mgp_f32* pos_ys = MGA_PUSH_ARRAY(temp.arena, mgp_f32, num_samples);
+        mgp_f32* commit_ys = MGA_PUSH_ARRAY(temp.arena, mgp_f32, num_samples);
+
+        mgp_u32 peak = 0;
+        mgp_u32 index = 0;
+        for (mga_bucket* bucket = mga_bucket_array_first(timeline->samples); bucket != NULL; bucket = mga_bucket_next(bucket)) {
+            mga_sample* samples = (mga_sample*)bucket->data;
+
+            for (mga_u32 j = 0; j < bucket->count; j++, index++) {
+                xs[index] = (mgp_f32)((mgp_f64)samples[j].time / 1e6);
+                pos_ys[index] = (mgp_f32)samples[j].pos / 1024.0f;
+                commit_ys[index] = (mgp_f32)samples[j].committed / 1024.0f;
+
+                if (commit_ys[index] > commit_ys[peak]) {
+                    peak = index;
+                }
+            }
+        }
+
+        mgp_vec4f color = _mgp_colors.default_draw[_mgp_draw_col_index++];
+        _mgp_draw_col_index %= sizeof(_mgp_colors.default_draw) / sizeof(_mgp_colors.default_draw[0]);
+
+        mga_str8 name = timeline->name;
+
+        mga_str8_builder builder = mga_str8_builder_begin(temp.arena);
+        mga_str8_append(&builder, name);
+        mga_str8_append(&builder, MGA_STR8(" pos"));
+        mga_str8 pos_label = mga_str8_builder_end(&builder);
+
+        builder = mga_str8_builder_begin(temp.arena);
+        mga_str8_append(&builder, name);
+        mga_str8_append(&builder, MGA_STR8(" committed"));
+        mga_str8 commit_label = mga_str8_builder_end(&builder);
+
+        builder = mga_str8_builder_begin(temp.arena);
+        mga_str8_append(&builder, name);
+        mga_str8_append(&builder, MGA_STR8(" peak "));
+        mga_str8_append_u64(&builder, (mga_u64)commit_ys[peak]);
+        mga_str8_append(&builder, MGA_STR8(" KiB"));
+        mga_str8 peak_label = mga_str8_builder_end(&builder);
+
+        // Lines need at least two points
+        if (num_samples > 1) {
+            mgp_lines_ex(num_samples, xs, pos_ys, 2.0f, MGP_LINE_SOLID, color, NULL, (mgp_string8){ pos_label.size, pos_label.str });
+            mgp_lines_ex(num_samples, xs, commit_ys, 2.0f, MGP_LINE_DASHED, color, NULL, (mgp_string8){ commit_label.size, commit_label.str });
+        }
+
+        mgp_points_ex(1, &xs[peak], &commit_ys[peak], 6.0f, color, NULL, (mgp_string8){ peak_label.size, peak_label.str });
+
+        mga_temp_end(temp);
+    }
+
+    mga_scratch_release(scratch);
+}
 
 typedef mgp_f32 mat4f[16];
 
@@ -1134,7 +1196,8 @@ void mgp_plot_show(void) {
 
     gfx_win_destroy(state.win);
 
-    _mgp_draw_cmds = (_mgp_draw_cmd_list){ 0 };
+    _mgp_draw_cmds = NULL;
+    _mgp_labels = NULL;
     _mgp_win_width = _mgp_default_win_width;
     _mgp_win_height = _mgp_default_win_height;
     _mgp_enable_legend = false;
@@ -1185,9 +1248,8 @@ static void _compute_init_view(_mgp_state* state) {
     view->top = -INFINITY;
     view->bottom =  INFINITY;
 
-    _mgp_draw_cmd_node* node = _mgp_draw_cmds.first;
-    for (; node != NULL; node = node->next) {
-        mgp_draw_cmd cmd = node->cmd;
+    FOR_EACH_DRAW_CMD(cmd_ptr) {
+        mgp_draw_cmd cmd = *cmd_ptr;
 
         switch (cmd.type) {
             case MGP_DRAW_POINTS: {
@@ -1485,9 +1547,8 @@ static void _init_text_data(_mgp_state* state) {
 static void _init_legend(_mgp_state* state) {
     _legend* legend = &state->legend;
 
-    _mgp_draw_cmd_node* node = _mgp_draw_cmds.first;
-    for (; node != NULL; node = node->next) {
-        if (node->cmd.label.size != 0) {
+    FOR_EACH_DRAW_CMD(cmd) {
+        if (cmd->label.size != 0) {
             legend->num_entries++;
         }
     }
@@ -1495,19 +1556,18 @@ static void _init_legend(_mgp_state* state) {
     legend->entries = MGA_PUSH_ZERO_ARRAY(_mgp_arena, _legend_entry, legend->num_entries);
 
     mgp_u32 index = 0;
-    node = _mgp_draw_cmds.first;
-    for (; node != NULL; node = node->next) {
-        if (node->cmd.label.size != 0) {
-            mgp_vec4f color = node->cmd.color;
-            if (node->cmd.colors != NULL) {
-                color = node->cmd.colors[0];
+    FOR_EACH_DRAW_CMD(cmd) {
+        if (cmd->label.size != 0) {
+            mgp_vec4f color = cmd->color;
+            if (cmd->colors != NULL) {
+                color = cmd->colors[0];
             }
 
-            legend->text_batch.capacity += node->cmd.label.size;
+            legend->text_batch.capacity += cmd->label.size;
 
             legend->entries[index++] = (_legend_entry){
                 .color = color,
-                .label = node->cmd.label
+                .label = cmd->label
             };
         }
     }
@@ -1810,9 +1870,8 @@ static void _init_graph_buffers(_mgp_state* state) {
     _line_batch* lines = &state->lines;
 
     // Counting number of each object
-    _mgp_draw_cmd_node* node = _mgp_draw_cmds.first;
-    for (; node != NULL; node = node->next) {
-        mgp_draw_cmd cmd = node->cmd;
+    FOR_EACH_DRAW_CMD(cmd_ptr) {
+        mgp_draw_cmd cmd = *cmd_ptr;
 
         switch (cmd.type) {
             case MGP_DRAW_POINTS: {
@@ -1835,9 +1894,16 @@ static void _init_graph_buffers(_mgp_state* state) {
     // Creating buffer data
     mga_temp scratch = mga_scratch_get(NULL, 0);
 
-    _quad_vert* quad_verts = MGA_PUSH_ARRAY(scratch.arena, _quad_vert, quads->num_quads * 4);
-    _point_vert* point_verts = MGA_PUSH_ARRAY(scratch.arena, _point_vert, points->num_points);
-    mgp_u32* line_indices = MGA_PUSH_ARRAY(scratch.arena, mgp_u32, lines->num_indices);
+    void* buffers[3] = { 0 };
+    mga_push_batch(scratch.arena, (mga_u64[3]){
+        sizeof(_quad_vert) * quads->num_quads * 4,
+        sizeof(_point_vert) * points->num_points,
+        sizeof(mgp_u32) * lines->num_indices
+    }, 3, buffers);
+
+    _quad_vert* quad_verts = (_quad_vert*)buffers[0];
+    _point_vert* point_verts = (_point_vert*)buffers[1];
+    mgp_u32* line_indices = (mgp_u32*)buffers[2];
 
     mgp_u32 quad_vert_index = 0;
     mgp_u32 point_vert_index = 0;
@@ -1847,9 +1913,8 @@ static void _init_graph_buffers(_mgp_state* state) {
     mgp_u32 line_vert_index = 0; 
     mgp_u32 line_indices_index = 0;
 
-    node = _mgp_draw_cmds.first;
-    for (; node != NULL; node = node->next) {
-        mgp_draw_cmd cmd = node->cmd;
+    FOR_EACH_DRAW_CMD(cmd_ptr) {
+        mgp_draw_cmd cmd = *cmd_ptr;
 
         mgp_vec4f* cols = &cmd.color;
         mgp_u32 num_cols = 1;
@@ -2236,6 +2301,14 @@ static void _update_legend(_mgp_state* state) {
 
     mga_scratch_release(scratch);
 }
+// Formatted straight into the arena, the text is only needed until _push_text
+static mgp_string8 _format_axes_num(mg_arena* arena, mgp_f32 num) {
+    mga_str8_builder builder = mga_str8_builder_begin(arena);
+    mga_str8_appendf(&builder, "%.4g", num);
+    mga_str8 str = mga_str8_builder_end(&builder);
+
+    return (mgp_string8){ MIN(str.size, _AXES_TEXT_MAX_CHARS), str.str };
+}
 static void _update_axes_text(_mgp_state* state) {
     _text_batch* axes_text = &state->axes_text;
     _view* view = &state->view;
@@ -2260,8 +2333,6 @@ static void _update_axes_text(_mgp_state* state) {
     }
     _push_text(verts, axes_text->capacity, &size, state->title, pos, ALIGN_CENTER, ALIGN_MIDDLE, font_size);
 
-    mgp_u8 num_text_buff[_AXES_TEXT_MAX_CHARS + 1] = { 0 };
-
     // X-Axis
     {
         mgp_u32 sections = MAX(3, MIN(6, graph_rect.w / 125));
@@ -2279,8 +2350,7 @@ static void _update_axes_text(_mgp_state* state) {
             pos.x = (mgp_f32)graph_rect.x + step * i;
 
             mgp_f32 view_pos = view->left + view_step * i;
-            snprintf((char*)num_text_buff, _AXES_TEXT_MAX_CHARS + 1, "%.4g", view_pos);
-            mgp_string8 num_text = _str8_from_cstr(num_text_buff);
+            mgp_string8 num_text = _format_axes_num(scratch.arena, view_pos);
 
             _x_text_align x_align = ALIGN_CENTER;
             if (i == 0) {
@@ -2309,8 +2379,7 @@ static void _update_axes_text(_mgp_state* state) {
             pos.y = (mgp_f32)graph_rect.y + step * i;
 
             mgp_f32 view_pos = view->top - view_step * i;
-            snprintf((char*)num_text_buff, _AXES_TEXT_MAX_CHARS + 1, "%.4g", view_pos);
-            mgp_string8 num_text = _str8_from_cstr(num_text_buff);
+            mgp_string8 num_text = _format_axes_num(scratch.arena, view_pos);
 
             _y_text_align y_align = ALIGN_MIDDLE;
             if (i == 0) {
@@ -2360,9 +2429,8 @@ static void _update_line_buffer(_mgp_state* state) {
     _line_vert* line_verts = MGA_PUSH_ARRAY(scratch.arena, _line_vert, lines->num_vertices);
     mgp_u32 index = 0;
 
-    _mgp_draw_cmd_node* node = _mgp_draw_cmds.first;
-    for (; node != NULL; node = node->next) {
-        mgp_draw_cmd cmd = node->cmd;
+    FOR_EACH_DRAW_CMD(cmd_ptr) {
+        mgp_draw_cmd cmd = *cmd_ptr;
 
         if (cmd.type != MGP_DRAW_LINES) {
             continue;
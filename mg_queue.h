@@ -0,0 +1,359 @@
+/*
+MGQ Header
+==================================================
+  __  __  ___  ___    _  _ ___   _   ___  ___ ___ 
+ |  \/  |/ __|/ _ \  | || | __| /_\ |   \| __| _ \
+ | |\/| | (_ | (_) | | __ | _| / _ \| |) | _||   /
+ |_|  |_|\___|\__\_\ |_||_|___/_/ \_\___/|___|_|_\
+
+==================================================
+*/
+
+#ifndef MG_QUEUE_H
+#define MG_QUEUE_H
+
+#ifndef MG_ARENA_H
+#   error "mg_arena.h required by mg_queue.h"
+#endif
+
+#ifndef MGQ_FUNC_DEF
+#   if defined(MGQ_STATIC)
+#      define MGQ_FUNC_DEF static
+#   elif defined(_WIN32) && defined(MGQ_DLL) && defined(MG_QUEUE_IMPL)
+#       define MGQ_FUNC_DEF __declspec(dllexport)
+#   elif defined(_WIN32) && defined(MGQ_DLL)
+#       define MGQ_FUNC_DEF __declspec(dllimport)
+#   else
+#      define MGQ_FUNC_DEF extern
+#   endif
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#ifndef MGQ_CACHE_LINE
+#   define MGQ_CACHE_LINE 64
+#endif
+
+// Single producer, single consumer queue of pointers
+typedef struct {
+    void** _slots;
+    mga_u64 _mask;
+
+    mga_u8 _pad0[MGQ_CACHE_LINE];
+    // Consumer
+    mga_u64 _head;
+    mga_u64 _cached_tail;
+
+    mga_u8 _pad1[MGQ_CACHE_LINE];
+    // Producer
+    mga_u64 _tail;
+    mga_u64 _cached_head;
+
+    mga_u8 _pad2[MGQ_CACHE_LINE];
+} mgq_spsc;
+
+typedef struct {
+    mga_u64 _seq;
+    void* _item;
+} _mgq_mpsc_slot;
+
+// Multiple producer, single consumer queue of pointers
+typedef struct {
+    _mgq_mpsc_slot* _slots;
+    mga_u64 _mask;
+
+    mga_u8 _pad0[MGQ_CACHE_LINE];
+    // Consumer
+    mga_u64 _head;
+
+    mga_u8 _pad1[MGQ_CACHE_LINE];
+    // Producers
+    mga_u64 _tail;
+
+    mga_u8 _pad2[MGQ_CACHE_LINE];
+} mgq_mpsc;
+
+MGQ_FUNC_DEF mgq_spsc* mgq_spsc_create(mg_arena* arena, mga_u32 capacity);
+MGQ_FUNC_DEF mga_u32 mgq_spsc_get_capacity(mgq_spsc* queue);
+
+MGQ_FUNC_DEF mga_b32 mgq_spsc_push(mgq_spsc* queue, void* item);
+MGQ_FUNC_DEF mga_u32 mgq_spsc_push_batch(mgq_spsc* queue, void** items, mga_u32 count);
+MGQ_FUNC_DEF mga_b32 mgq_spsc_pop(mgq_spsc* queue, void** item);
+MGQ_FUNC_DEF mga_u32 mgq_spsc_pop_batch(mgq_spsc* queue, void** items, mga_u32 max_count);
+
+MGQ_FUNC_DEF mgq_mpsc* mgq_mpsc_create(mg_arena* arena, mga_u32 capacity);
+MGQ_FUNC_DEF mga_u32 mgq_mpsc_get_capacity(mgq_mpsc* queue);
+
+MGQ_FUNC_DEF mga_b32 mgq_mpsc_push(mgq_mpsc* queue, void* item);
+MGQ_FUNC_DEF mga_u32 mgq_mpsc_push_batch(mgq_mpsc* queue, void** items, mga_u32 count);
+MGQ_FUNC_DEF mga_b32 mgq_mpsc_pop(mgq_mpsc* queue, void** item);
+MGQ_FUNC_DEF mga_u32 mgq_mpsc_pop_batch(mgq_mpsc* queue, void** items, mga_u32 max_count);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // MG_QUEUE_H
+
+/*
+MGQ Implementation
+==========================================================================================
+  __  __  ___  ___    ___ __  __ ___ _    ___ __  __ ___ _  _ _____ _ _____ ___ ___  _  _ 
+ |  \/  |/ __|/ _ \  |_ _|  \/  | _ \ |  | __|  \/  | __| \| |_   _/_\_   _|_ _/ _ \| \| |
+ | |\/| | (_ | (_) |  | || |\/| |  _/ |__| _|| |\/| | _|| .` | | |/ _ \| |  | | (_) | .` |
+ |_|  |_|\___|\__\_\ |___|_|  |_|_| |____|___|_|  |_|___|_|\_| |_/_/ \_\_| |___\___/|_|\_|
+
+==========================================================================================
+*/
+
+#ifdef MG_QUEUE_IMPL
+
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#if defined(_MSC_VER) && !defined(__clang__)
+#    include <intrin.h>
+#    define MGQ_LOAD_RELAXED(p) (*(volatile mga_u64*)(p))
+#    define MGQ_LOAD_ACQUIRE(p) ((mga_u64)_InterlockedOr64((volatile __int64*)(p), 0))
+#    define MGQ_STORE_RELEASE(p, v) _InterlockedExchange64((volatile __int64*)(p), (__int64)(v))
+// expected is a pointer to a local variable, like __atomic_compare_exchange_n
+#    define MGQ_CAS(p, expected, desired) \
+        ((mga_u64)_InterlockedCompareExchange64((volatile __int64*)(p), (__int64)(desired), (__int64)*(expected)) == *(expected))
+#else
+#    define MGQ_LOAD_RELAXED(p) __atomic_load_n((p), __ATOMIC_RELAXED)
+#    define MGQ_LOAD_ACQUIRE(p) __atomic_load_n((p), __ATOMIC_ACQUIRE)
+#    define MGQ_STORE_RELEASE(p, v) __atomic_store_n((p), (v), __ATOMIC_RELEASE)
+#    define MGQ_CAS(p, expected, desired) \
+        __atomic_compare_exchange_n((p), (expected), (desired), 0, __ATOMIC_ACQ_REL, __ATOMIC_RELAXED)
+#endif
+
+#define MGQ_MIN(a, b) ((a) < (b) ? (a) : (b))
+
+static mga_u64 _mgq_round_pow2(mga_u32 capacity) {
+    mga_u64 out = 2;
+    while (out < capacity) {
+        out <<= 1;
+    }
+    return out;
+}
+
+/*
+SPSC
+Producer and consumer each keep a cached copy of the other side's index,
+so the shared index is only read when the cached one says the queue is full/empty
+*/
+
+mgq_spsc* mgq_spsc_create(mg_arena* arena, mga_u32 capacity) {
+    mga_u64 size = _mgq_round_pow2(capacity);
+    mga_u64 start_pos = mga_get_pos(arena);
+
+    mgq_spsc* out = MGA_PUSH_ZERO_STRUCT(arena, mgq_spsc);
+    if (out == NULL) {
+        return NULL;
+    }
+
+    out->_slots = MGA_PUSH_ZERO_ARRAY(arena, void*, size);
+    if (out->_slots == NULL) {
+        mga_pop_to(arena, start_pos);
+        return NULL;
+    }
+
+    out->_mask = size - 1;
+
+    return out;
+}
+mga_u32 mgq_spsc_get_capacity(mgq_spsc* queue) {
+    return (mga_u32)(queue->_mask + 1);
+}
+
+mga_u32 mgq_spsc_push_batch(mgq_spsc* queue, void** items, mga_u32 count) {
+    mga_u64 tail = queue->_tail;
+    mga_u64 capacity = queue->_mask + 1;
+
+    if (tail - queue->_cached_head + count > capacity) {
+        queue->_cached_head = MGQ_LOAD_ACQUIRE(&queue->_head);
+    }
+
+    mga_u32 num = (mga_u32)MGQ_MIN((mga_u64)count, capacity - (tail - queue->_cached_head));
+    for (mga_u32 i = 0; i < num; i++) {
+        queue->_slots[(tail + i) & queue->_mask] = items[i];
+    }
+
+    if (num > 0) {
+        MGQ_STORE_RELEASE(&queue->_tail, tail + num);
+    }
+
+    return num;
+}
+mga_b32 mgq_spsc_push(mgq_spsc* queue, void* item) {
+    return mgq_spsc_push_batch(queue, &item, 1) == 1;
+}
+
+mga_u32 mgq_spsc_pop_batch(mgq_spsc* queue, void** items, mga_u32 max_count) {
+    mga_u64 head = queue->_head;
+
+    if (queue->_cached_tail - head < max_count) {
+        queue->_cached_tail = MGQ_LOAD_ACQUIRE(&queue->_tail);
+    }
+
+    mga_u32 num = (mga_u32)MGQ_MIN((mga_u64)max_count, queue->_cached_tail - head);
+    for (mga_u32 i = 0; i < num; i++) {
+        items[i] = queue->_slots[(head + i) & queue->_mask];
+    }
+
+    if (num > 0) {
+        MGQ_STORE_RELEASE(&queue->_head, head + num);
+    }
+
+    return num;
+}
+mga_b32 mgq_spsc_pop(mgq_spsc* queue, void** item) {
+    return mgq_spsc_pop_batch(queue, item, 1) == 1;
+}
+
+/*
+MPSC
+Bounded queue based on Dmitry Vyukov's design.
+Every slot has a sequence number: a slot at position pos is free when seq == pos,
+and it holds an item when seq == pos + 1.
+*/
+
+mgq_mpsc* mgq_mpsc_create(mg_arena* arena, mga_u32 capacity) {
+    mga_u64 size = _mgq_round_pow2(capacity);
+    mga_u64 start_pos = mga_get_pos(arena);
+
+    mgq_mpsc* out = MGA_PUSH_ZERO_STRUCT(arena, mgq_mpsc);
+    if (out == NULL) {
+        return NULL;
+    }
+
+    out->_slots = MGA_PUSH_ARRAY(arena, _mgq_mpsc_slot, size);
+    if (out->_slots == NULL) {
+        mga_pop_to(arena, start_pos);
+        return NULL;
+    }
+
+    for (mga_u64 i = 0; i < size; i++) {
+        out->_slots[i]._seq = i;
+        out->_slots[i]._item = NULL;
+    }
+
+    out->_mask = size - 1;
+
+    return out;
+}
+mga_u32 mgq_mpsc_get_capacity(mgq_mpsc* queue) {
+    return (mga_u32)(queue->_mask + 1);
+}
+
+mga_u32 mgq_mpsc_push_batch(mgq_mpsc* queue, void** items, mga_u32 count) {
+    mga_u64 capacity = queue->_mask + 1;
+    mga_u64 num = MGQ_MIN((mga_u64)count, capacity);
+    if (num == 0) {
+        return 0;
+    }
+
+    mga_u64 pos = MGQ_LOAD_RELAXED(&queue->_tail);
+
+    while (1) {
+        // The consumer frees slots in order, so the last slot being free
+        // means that all of the slots before it are free too
+        _mgq_mpsc_slot* last = &queue->_slots[(pos + num - 1) & queue->_mask];
+        mga_u64 seq = MGQ_LOAD_ACQUIRE(&last->_seq);
+        mga_i64 diff = (mga_i64)(seq - (pos + num - 1));
+
+        if (diff == 0) {
+            mga_u64 expected = pos;
+            if (MGQ_CAS(&queue->_tail, &expected, pos + num)) {
+                break;
+            }
+        } else if (diff < 0) {
+            // Not enough room, try fewer items
+            if (num == 1) {
+                return 0;
+            }
+            num >>= 1;
+        }
+
+        pos = MGQ_LOAD_RELAXED(&queue->_tail);
+    }
+
+    for (mga_u64 i = 0; i < num; i++) {
+        _mgq_mpsc_slot* slot = &queue->_slots[(pos + i) & queue->_mask];
+        slot->_item = items[i];
+        MGQ_STORE_RELEASE(&slot->_seq, pos + i + 1);
+    }
+
+    return (mga_u32)num;
+}
+mga_b32 mgq_mpsc_push(mgq_mpsc* queue, void* item) {
+    return mgq_mpsc_push_batch(queue, &item, 1) == 1;
+}
+
+mga_u32 mgq_mpsc_pop_batch(mgq_mpsc* queue, void** items, mga_u32 max_count) {
+    mga_u64 head = queue->_head;
+    mga_u64 capacity = queue->_mask + 1;
+
+    mga_u32 num = 0;
+    while (num < max_count) {
+        _mgq_mpsc_slot* slot = &queue->_slots[(head + num) & queue->_mask];
+        if (MGQ_LOAD_ACQUIRE(&slot->_seq) != head + num + 1) {
+            break;
+        }
+
+        items[num] = slot->_item;
+        MGQ_STORE_RELEASE(&slot->_seq, head + num + capacity);
+        num++;
+    }
+
+    queue->_head = head + num;
+
+    return num;
+}
+mga_b32 mgq_mpsc_pop(mgq_mpsc* queue, void** item) {
+    return mgq_mpsc_pop_batch(queue, item, 1) == 1;
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // MG_QUEUE_IMPL
+
+/*
+License
+=================================
+  _    ___ ___ ___ _  _ ___ ___ 
+ | |  |_ _/ __| __| \| / __| __|
+ | |__ | | (__| _|| .` \__ \ _| 
+ |____|___\___|___|_|\_|___/___|
+                                
+=================================
+
+MIT License
+
+Copyright (c) 2023 Magicalbat
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
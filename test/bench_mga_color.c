@@ -0,0 +1,108 @@
+/*
+Linux Compile:
+clang -O2 test/bench_mga_color.c -lpthread -o bin/bench_mga_color
+
+Measures the effect of cache_color on streaming workloads with 1, 4, and 16 threads.
+Every thread creates one arena per stream and pushes one array onto each arena.
+Without coloring, every array starts at the same offset in its page, so the
+streams compete for the same cache sets, and loads alias with stores (4K aliasing).
+*/
+
+#include <stdio.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <time.h>
+
+#include <pthread.h>
+
+#define MG_ARENA_IMPL
+#include "../mg_arena.h"
+
+#define NUM_STREAMS 16
+#define STREAM_FLOATS 1024
+#define NUM_ROUNDS 20000
+
+static uint64_t now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+typedef struct {
+    bool cache_color;
+    float checksum;
+} worker;
+
+static void* worker_func(void* arg) {
+    worker* w = (worker*)arg;
+
+    mg_arena* arenas[NUM_STREAMS];
+    float* streams[NUM_STREAMS];
+
+    for (int i = 0; i < NUM_STREAMS; i++) {
+        arenas[i] = mga_create(&(mga_desc){
+            .desired_max_size = MGA_MiB(1),
+            .cache_color = w->cache_color
+        });
+
+        streams[i] = MGA_PUSH_ARRAY(arenas[i], float, STREAM_FLOATS);
+        for (int j = 0; j < STREAM_FLOATS; j++) {
+            streams[i][j] = (float)(i + j);
+        }
+    }
+
+    // The last stream is the output
+    float* out = streams[NUM_STREAMS - 1];
+    for (int r = 0; r < NUM_ROUNDS; r++) {
+        for (int j = 0; j < STREAM_FLOATS; j++) {
+            float sum = 0.0f;
+            for (int i = 0; i < NUM_STREAMS - 1; i++) {
+                sum += streams[i][j];
+            }
+            out[j] = sum * 0.0625f;
+        }
+    }
+
+    w->checksum = out[STREAM_FLOATS / 2];
+
+    for (int i = 0; i < NUM_STREAMS; i++) {
+        mga_destroy(arenas[i]);
+    }
+
+    return NULL;
+}
+
+static void run(uint32_t num_threads, bool cache_color) {
+    pthread_t threads[16];
+    worker workers[16];
+
+    uint64_t start = now_ns();
+
+    for (uint32_t i = 0; i < num_threads; i++) {
+        workers[i] = (worker){ .cache_color = cache_color };
+        pthread_create(&threads[i], NULL, worker_func, &workers[i]);
+    }
+
+    float checksum = 0.0f;
+    for (uint32_t i = 0; i < num_threads; i++) {
+        pthread_join(threads[i], NULL);
+        checksum += workers[i].checksum;
+    }
+
+    uint64_t end = now_ns();
+
+    double bytes = (double)num_threads * NUM_ROUNDS * NUM_STREAMS * STREAM_FLOATS * sizeof(float);
+    double seconds = (double)(end - start) / 1e9;
+    printf("%2u thread(s), %-10s %8.2f GB/s (checksum %.0f)\n",
+        num_threads, cache_color ? "colored" : "uncolored", bytes / seconds / 1e9, checksum);
+}
+
+int main(void) {
+    uint32_t thread_counts[] = { 1, 4, 16 };
+    for (uint32_t i = 0; i < 3; i++) {
+        run(thread_counts[i], false);
+        run(thread_counts[i], true);
+    }
+
+    return 0;
+}
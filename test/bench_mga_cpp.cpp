@@ -0,0 +1,163 @@
+/*
+Linux Compile:
+clang++ -std=c++17 -O2 test/bench_mga_cpp.cpp -o bin/bench_mga_cpp
+
+Compares container heavy workloads on the default allocator with
+the same workloads on an arena, through mga::allocator and mga::memory_resource.
+The arena versions run on both the reserve and the malloc backend.
+Every round of the arena versions is wrapped in an mga::temp_scope.
+*/
+
+#include <stdio.h>
+#include <stdint.h>
+#include <time.h>
+
+#include <string>
+#include <vector>
+#include <unordered_map>
+
+#define MG_ARENA_IMPL
+#include "../mg_arena.h"
+#include "../mg_arena.hpp"
+
+#define NUM_ROUNDS 20
+#define NUM_ITEMS 100000
+
+static uint64_t now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+static const char* long_string = "A string that is too long for the small string optimization";
+
+// Keeps the results alive so the workloads are not optimized out
+static volatile uint64_t sink = 0;
+
+template <typename Vector>
+static void vector_workload(Vector& vec) {
+    for (int i = 0; i < NUM_ITEMS; i++) {
+        vec.push_back(i);
+    }
+    sink += vec[NUM_ITEMS / 2];
+}
+
+template <typename Map>
+static void map_workload(Map& map) {
+    for (int i = 0; i < NUM_ITEMS; i++) {
+        map[i * 7] = i;
+    }
+    sink += map.size();
+}
+
+template <typename Strings>
+static void string_workload(Strings& strings) {
+    for (int i = 0; i < NUM_ITEMS; i++) {
+        strings.emplace_back(long_string);
+        strings.back().push_back((char)('a' + i % 26));
+    }
+    sink += strings[NUM_ITEMS / 2].size();
+}
+
+static void print_result(const char* workload, const char* allocator, uint64_t total_ns) {
+    printf("%-14s %-30s %8.3f ms/round\n", workload, allocator,
+        (double)total_ns / (double)NUM_ROUNDS / 1e6);
+}
+
+static const char* backend_names[] = { "default", "reserve", "malloc" };
+
+static void print_arena_result(const char* workload, const char* allocator, mga_backend backend, uint64_t total_ns) {
+    char name[64];
+    snprintf(name, sizeof(name), "%s (%s)", allocator, backend_names[backend]);
+    print_result(workload, name, total_ns);
+}
+
+// Runs body(arena) NUM_ROUNDS times, resetting the arena after every round
+template <typename Body>
+static uint64_t run_arena(mg_arena* arena, Body body) {
+    uint64_t start = now_ns();
+    for (int r = 0; r < NUM_ROUNDS; r++) {
+        mga::temp_scope temp(arena);
+        body(arena);
+    }
+    return now_ns() - start;
+}
+
+template <typename Body>
+static uint64_t run_default(Body body) {
+    uint64_t start = now_ns();
+    for (int r = 0; r < NUM_ROUNDS; r++) {
+        body();
+    }
+    return now_ns() - start;
+}
+
+static void run_arena_workloads(mga_backend backend) {
+    mga_desc desc = { };
+    desc.desired_max_size = MGA_GiB(1);
+    desc.desired_block_size = MGA_MiB(1);
+    desc.backend = backend;
+    mg_arena* arena = mga_create(&desc);
+
+    typedef std::pair<const int, int> map_pair;
+    typedef std::basic_string<char, std::char_traits<char>, mga::allocator<char>> arena_string;
+
+    print_arena_result("vector<int>", "mga::allocator", backend, run_arena(arena, [](mg_arena* a) {
+        std::vector<int, mga::allocator<int>> vec(a);
+        vector_workload(vec);
+    }));
+    print_arena_result("unordered_map", "mga::allocator", backend, run_arena(arena, [](mg_arena* a) {
+        std::unordered_map<int, int, std::hash<int>, std::equal_to<int>, mga::allocator<map_pair>> map(
+            16, std::hash<int>(), std::equal_to<int>(), mga::allocator<map_pair>(a)
+        );
+        map_workload(map);
+    }));
+    print_arena_result("vector<string>", "mga::allocator", backend, run_arena(arena, [](mg_arena* a) {
+        std::vector<arena_string, mga::allocator<arena_string>> strings(a);
+        for (int i = 0; i < NUM_ITEMS; i++) {
+            strings.emplace_back(long_string, mga::allocator<char>(a));
+            strings.back().push_back((char)('a' + i % 26));
+        }
+        sink += strings[NUM_ITEMS / 2].size();
+    }));
+
+#ifdef MGA_HAS_PMR
+    print_arena_result("vector<int>", "mga::memory_resource", backend, run_arena(arena, [](mg_arena* a) {
+        mga::memory_resource resource(a);
+        std::pmr::vector<int> vec(&resource);
+        vector_workload(vec);
+    }));
+    print_arena_result("unordered_map", "mga::memory_resource", backend, run_arena(arena, [](mg_arena* a) {
+        mga::memory_resource resource(a);
+        std::pmr::unordered_map<int, int> map(&resource);
+        map_workload(map);
+    }));
+    print_arena_result("vector<string>", "mga::memory_resource", backend, run_arena(arena, [](mg_arena* a) {
+        mga::memory_resource resource(a);
+        std::pmr::vector<std::pmr::string> strings(&resource);
+        string_workload(strings);
+    }));
+#endif
+
+    mga_destroy(arena);
+}
+
+int main(void) {
+    print_result("vector<int>", "std::allocator", run_default([]() {
+        std::vector<int> vec;
+        vector_workload(vec);
+    }));
+    print_result("unordered_map", "std::allocator", run_default([]() {
+        std::unordered_map<int, int> map;
+        map_workload(map);
+    }));
+    print_result("vector<string>", "std::allocator", run_default([]() {
+        std::vector<std::string> strings;
+        string_workload(strings);
+    }));
+
+    run_arena_workloads(MGA_BACKEND_RESERVE);
+    run_arena_workloads(MGA_BACKEND_MALLOC);
+
+    return 0;
+}
@@ -0,0 +1,186 @@
+/*
+Linux Compile:
+clang -O2 test/bench_mgq.c -lpthread -o bin/bench_mgq
+
+Measures throughput and latency of mg_queue with 1, 4, and 16 producers.
+Every item is a small sample batch; the payloads are either pushed into
+a per producer mga_ring or allocated with malloc, for comparison.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#include <time.h>
+
+#include <pthread.h>
+#include <sched.h>
+
+#define MG_ARENA_IMPL
+#include "../mg_arena.h"
+
+#define MG_QUEUE_IMPL
+#include "../mg_queue.h"
+
+#define ITEMS_PER_RUN (1 << 20)
+#define BATCH_SIZE 32
+#define SAMPLES_PER_ITEM 8
+
+typedef struct {
+    uint64_t timestamp;
+    mga_ring* ring;
+    float samples[SAMPLES_PER_ITEM];
+} payload;
+
+static uint64_t now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+typedef struct {
+    bool use_spsc;
+    bool use_ring;
+    mgq_spsc* spsc;
+    mgq_mpsc* mpsc;
+    mga_ring* ring;
+    uint64_t num_items;
+} producer;
+
+static payload* make_payload(producer* p) {
+    payload* out = NULL;
+
+    if (p->use_ring) {
+        // Wait for the consumer to release memory
+        while (mga_ring_get_free(p->ring) < sizeof(payload)) { sched_yield(); }
+        out = (payload*)mga_ring_push(p->ring, sizeof(payload));
+    } else {
+        out = (payload*)malloc(sizeof(payload));
+    }
+
+    out->ring = p->ring;
+    for (int i = 0; i < SAMPLES_PER_ITEM; i++) {
+        out->samples[i] = (float)i;
+    }
+
+    return out;
+}
+
+static void* producer_func(void* arg) {
+    producer* p = (producer*)arg;
+
+    void* batch[BATCH_SIZE];
+    for (uint64_t i = 0; i < p->num_items; i += BATCH_SIZE) {
+        for (int j = 0; j < BATCH_SIZE; j++) {
+            batch[j] = make_payload(p);
+        }
+        if (p->use_ring) {
+            mga_ring_publish(p->ring);
+        }
+
+        uint64_t timestamp = now_ns();
+        for (int j = 0; j < BATCH_SIZE; j++) {
+            ((payload*)batch[j])->timestamp = timestamp;
+        }
+
+        uint32_t pushed = 0;
+        while (1) {
+            pushed += p->use_spsc ?
+                mgq_spsc_push_batch(p->spsc, batch + pushed, BATCH_SIZE - pushed) :
+                mgq_mpsc_push_batch(p->mpsc, batch + pushed, BATCH_SIZE - pushed);
+
+            if (pushed == BATCH_SIZE) { break; }
+            sched_yield();
+        }
+    }
+
+    return NULL;
+}
+
+static void run(mg_arena* arena, uint32_t num_producers, bool use_spsc, bool use_ring) {
+    mga_temp temp = mga_temp_begin(arena);
+
+    mgq_spsc* spsc = use_spsc ? mgq_spsc_create(temp.arena, 4096) : NULL;
+    mgq_mpsc* mpsc = use_spsc ? NULL : mgq_mpsc_create(temp.arena, 4096);
+
+    pthread_t threads[16];
+    producer producers[16];
+
+    uint64_t start = now_ns();
+
+    for (uint32_t i = 0; i < num_producers; i++) {
+        producers[i] = (producer){
+            .use_spsc = use_spsc,
+            .use_ring = use_ring,
+            .spsc = spsc,
+            .mpsc = mpsc,
+            .ring = use_ring ? mga_ring_create(&(mga_ring_desc){ .desired_size = MGA_MiB(1) }) : NULL,
+            .num_items = ITEMS_PER_RUN / num_producers
+        };
+        pthread_create(&threads[i], NULL, producer_func, &producers[i]);
+    }
+
+    uint64_t total_latency = 0;
+    uint64_t received = 0;
+    float checksum = 0.0f;
+
+    void* items[BATCH_SIZE];
+    while (received < ITEMS_PER_RUN) {
+        uint32_t num = use_spsc ?
+            mgq_spsc_pop_batch(spsc, items, BATCH_SIZE) :
+            mgq_mpsc_pop_batch(mpsc, items, BATCH_SIZE);
+        if (num == 0) {
+            sched_yield();
+            continue;
+        }
+
+        uint64_t t = now_ns();
+        for (uint32_t i = 0; i < num; i++) {
+            payload* p = (payload*)items[i];
+            total_latency += t - p->timestamp;
+            checksum += p->samples[SAMPLES_PER_ITEM - 1];
+
+            if (use_ring) {
+                mga_ring_release(p->ring, sizeof(payload));
+            } else {
+                free(p);
+            }
+        }
+
+        received += num;
+    }
+
+    uint64_t end = now_ns();
+
+    for (uint32_t i = 0; i < num_producers; i++) {
+        pthread_join(threads[i], NULL);
+        if (use_ring) {
+            mga_ring_destroy(producers[i].ring);
+        }
+    }
+
+    double seconds = (double)(end - start) / 1e9;
+    printf("%s, %2u producer(s), %-6s payloads: %8.2f M items/s, %10.1f ns avg latency (checksum %.0f)\n",
+        use_spsc ? "SPSC" : "MPSC", num_producers, use_ring ? "ring" : "malloc",
+        (double)received / seconds / 1e6, (double)total_latency / (double)received, checksum);
+
+    mga_temp_end(temp);
+}
+
+int main(void) {
+    mg_arena* arena = mga_create(&(mga_desc){ .desired_max_size = MGA_MiB(64) });
+
+    run(arena, 1, true, true);
+    run(arena, 1, true, false);
+
+    uint32_t producer_counts[] = { 1, 4, 16 };
+    for (uint32_t i = 0; i < 3; i++) {
+        run(arena, producer_counts[i], false, true);
+        run(arena, producer_counts[i], false, false);
+    }
+
+    mga_destroy(arena);
+
+    return 0;
+}
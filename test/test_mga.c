@@ -1,8 +1,16 @@
 #include <stdio.h>
 #include <stdbool.h>
 #include <stdint.h>
+#include <stdlib.h>
 #include <string.h>
 
+#include <pthread.h>
+
+static int num_mallocs = 0;
+static void* test_malloc(size_t size) { num_mallocs++; return malloc(size); }
+
+#define MGA_MALLOC test_malloc
+#define MGA_FREE free
 #define MGA_STATIC
 #define MG_ARENA_IMPL
 #include "../mg_arena.h"
@@ -23,6 +31,7 @@ bool test_misc(void) {
     TEST_ASSERT(MGA_GiB(2) == 2147483648, "GiB");
 
     TEST_ASSERT(sizeof(mga_i32) == 4, "mga_i32 size");
+    TEST_ASSERT(sizeof(mga_i64) == 8, "mga_i64 size");
     TEST_ASSERT(sizeof(mga_u8 ) == 1, "mga_u8  size");
     TEST_ASSERT(sizeof(mga_u32) == 4, "mga_u32 size");
     TEST_ASSERT(sizeof(mga_u64) == 8, "mga_u64 size");
@@ -125,7 +134,7 @@ bool test_pop(void) {
     TEST_ASSERT(start_pos - end_pos == 1024, "pop");
 
     mga_reset(arena);
-#ifdef MGA_MIN_POS
+#ifndef MGA_FORCE_MALLOC
     TEST_ASSERT(mga_get_pos(arena) == MGA_MIN_POS, "reset");
 #else
     TEST_ASSERT(mga_get_pos(arena) == 0, "reset");
@@ -150,6 +159,926 @@ bool test_temp(void) {
     return true;
 }
 
+bool test_prepare(void) {
+    mga_u64 start_pos = arena->_pos;
+
+    // Small pushes across many blocks keep their data
+    mga_u64* values[4096];
+    for (mga_u64 i = 0; i < 4096; i++) {
+        values[i] = (mga_u64*)mga_push(arena, 24 + (i % 3) * 40);
+        TEST_ASSERT(values[i] != NULL, "small push");
+        TEST_ASSERT(((uintptr_t)values[i] & (arena->_align - 1)) == 0, "small push align");
+        *values[i] = i;
+    }
+    for (mga_u64 i = 0; i < 4096; i++) {
+        TEST_ASSERT(*values[i] == i, "small push data");
+    }
+
+    mga_pop_to(arena, start_pos);
+    TEST_ASSERT(arena->_pos == start_pos, "pop small pushes");
+
+    TEST_ASSERT(mga_prepare(arena, arena->_block_size * 2), "prepare");
+    mga_u64 prepared_pos = arena->_pos;
+
+    for (mga_u32 i = 0; i < arena->_block_size / 8; i++) {
+        mga_u64* value = MGA_PUSH_UNCHECKED_STRUCT(arena, mga_u64);
+        *value = i;
+
+        mga_u64* arr = MGA_PUSH_UNCHECKED_ARRAY(arena, mga_u64, 1);
+        arr[0] = i;
+    }
+    TEST_ASSERT(arena->_pos - prepared_pos == arena->_block_size * 2, "unchecked pushes");
+
+    TEST_ASSERT(!mga_prepare(arena, arena->_size), "prepare too much");
+    TEST_ASSERT(mga_get_error(arena).code == MGA_ERR_OUT_OF_MEMORY, "prepare error");
+
+    mga_pop_to(arena, start_pos);
+    TEST_ASSERT(arena->_pos == start_pos, "pop unchecked pushes");
+
+    return true;
+}
+
+bool test_batch(void) {
+    mga_u64 start_pos = arena->_pos;
+
+    mga_u64 sizes[4] = { 3, sizeof(float) * 100, arena->_block_size * 3, 1 };
+    void* ptrs[4] = { 0 };
+
+    TEST_ASSERT(mga_push_batch(arena, sizes, 4, ptrs), "push batch");
+    for (int i = 0; i < 4; i++) {
+        TEST_ASSERT(ptrs[i] != NULL, "batch pointers");
+        TEST_ASSERT(((uintptr_t)ptrs[i] & (arena->_align - 1)) == 0, "batch alignment");
+        memset(ptrs[i], i, sizes[i]);
+    }
+    for (int i = 0; i < 3; i++) {
+        TEST_ASSERT((mga_u8*)ptrs[i] + sizes[i] <= (mga_u8*)ptrs[i + 1], "batch layout");
+    }
+    TEST_ASSERT(((mga_u8*)ptrs[2])[sizes[2] - 1] == 2, "batch data");
+
+    mga_u64 pos = arena->_pos;
+    mga_u64 big_sizes[2] = { 16, arena->_size };
+    TEST_ASSERT(!mga_push_batch(arena, big_sizes, 2, ptrs), "batch too large");
+    TEST_ASSERT(ptrs[0] == NULL && ptrs[1] == NULL, "failed batch pointers");
+    TEST_ASSERT(arena->_pos == pos, "failed batch pos");
+    TEST_ASSERT(mga_get_error(arena).code == MGA_ERR_OUT_OF_MEMORY, "batch error");
+
+    mga_pop_to(arena, start_pos);
+
+    return true;
+}
+
+bool test_aligned(void) {
+    mga_u64 start_pos = arena->_pos;
+
+    mga_u32 aligns[] = { 1, 2, 16, 32, 64, 256, 4096 };
+    for (mga_u32 i = 0; i < sizeof(aligns) / sizeof(aligns[0]); i++) {
+        mga_push(arena, 1);
+
+        mga_u8* ptr = (mga_u8*)mga_push_aligned(arena, 100, aligns[i]);
+        TEST_ASSERT(ptr != NULL, "push aligned");
+        TEST_ASSERT(((uintptr_t)ptr & (aligns[i] - 1)) == 0, "push aligned alignment");
+        memset(ptr, 0xff, 100);
+    }
+
+    // Small alignments do not pad to the arena alignment
+    mga_u8* a = (mga_u8*)mga_push_aligned(arena, 1, 1);
+    mga_u8* b = (mga_u8*)mga_push_aligned(arena, 1, 1);
+    TEST_ASSERT(b == a + 1, "push aligned without padding");
+
+    // Crossing blocks and malloc nodes keeps the alignment
+    for (int i = 0; i < 8; i++) {
+        mga_u8* big = (mga_u8*)mga_push_aligned(arena, arena->_block_size / 2 + 3, 512);
+        TEST_ASSERT(big != NULL && ((uintptr_t)big & 511) == 0, "large aligned push");
+    }
+
+    mga_u8* line0 = (mga_u8*)mga_push_cache_line(arena, 4);
+    mga_u8* line1 = (mga_u8*)mga_push_cache_line(arena, 4);
+    TEST_ASSERT(((uintptr_t)line0 & (MGA_CACHE_LINE - 1)) == 0, "cache line alignment");
+    TEST_ASSERT(line1 - line0 == MGA_CACHE_LINE, "cache line padding");
+
+    mga_u8* page = (mga_u8*)mga_push_page(arena, 10);
+    TEST_ASSERT(page != NULL && ((uintptr_t)page & 4095) == 0, "page alignment");
+    TEST_ASSERT(arena->_pos - (page - arena->_fast_base) >= 4096, "page padding");
+
+    mga_pop_to(arena, start_pos);
+
+    return true;
+}
+
+bool test_copy(void) {
+    mga_u64 start_pos = arena->_pos;
+
+    mga_u8 small[100];
+    for (int i = 0; i < 100; i++) {
+        small[i] = (mga_u8)i;
+    }
+    mga_u8* small_copy = (mga_u8*)mga_push_copy(arena, small, sizeof(small));
+    TEST_ASSERT(small_copy != NULL && memcmp(small, small_copy, sizeof(small)) == 0, "small copy");
+
+    // Unaligned source and odd size for the streaming copy
+    mga_u64 size = MGA_STREAM_THRESHOLD + 77;
+    mga_u8* src = (mga_u8*)mga_push(arena, size + 1) + 1;
+    for (mga_u64 i = 0; i < size; i++) {
+        src[i] = (mga_u8)(i * 7);
+    }
+
+    mga_push(arena, 3);
+    mga_u8* large_copy = (mga_u8*)mga_push_copy(arena, src, size);
+    TEST_ASSERT(large_copy != NULL && memcmp(src, large_copy, size) == 0, "large copy");
+
+    mga_pop_to(arena, start_pos);
+
+    return true;
+}
+
+bool test_top(void) {
+#ifdef MGA_FORCE_MALLOC
+    TEST_ASSERT(mga_push_top(arena, 16) == NULL, "top unsupported");
+    TEST_ASSERT(mga_get_error(arena).code == MGA_ERR_UNSUPPORTED, "top error");
+#else
+    mga_u64 start_pos = mga_get_pos(arena);
+    mga_u64 start_top = mga_get_top_pos(arena);
+    TEST_ASSERT(start_top == mga_get_size(arena), "top start");
+
+    int* result = MGA_PUSH_TOP_ARRAY(arena, int, 64);
+    TEST_ASSERT(result != NULL, "push top");
+    TEST_ASSERT((mga_u8*)result + sizeof(int) * 64 <= (mga_u8*)arena + start_top, "push top bounds");
+    for (int i = 0; i < 64; i++) {
+        result[i] = i;
+    }
+
+    mga_temp temp = mga_temp_begin(arena);
+    int* scratch = MGA_PUSH_ZERO_ARRAY(temp.arena, int, 64);
+    TEST_ASSERT(scratch != NULL && (void*)(scratch + 64) <= (void*)result, "bottom below top");
+    mga_temp_end(temp);
+
+    TEST_ASSERT(result[63] == 63, "top survives temp end");
+
+    char* big = (char*)mga_push_top(arena, arena->_block_size * 2 + 8);
+    TEST_ASSERT(big != NULL, "push top across blocks");
+    big[0] = 1;
+    big[arena->_block_size * 2 + 7] = 1;
+
+    TEST_ASSERT(mga_push(arena, mga_get_top_pos(arena)) == NULL, "shared budget");
+    mga_error err = mga_get_error(arena);
+    TEST_ASSERT(err.code == MGA_ERR_OUT_OF_MEMORY, "shared budget error");
+
+    mga_reset_top(arena);
+    TEST_ASSERT(mga_get_top_pos(arena) == start_top, "reset top");
+    TEST_ASSERT(mga_get_pos(arena) == start_pos, "reset top keeps bottom");
+
+    MGA_PUSH_TOP_ZERO_STRUCT(arena, float);
+    mga_reset(arena);
+    TEST_ASSERT(mga_get_top_pos(arena) == start_top, "reset clears top");
+#endif
+
+    return true;
+}
+
+bool test_node_cache(void) {
+    mg_arena* malloc_arena = mga_create(&(mga_desc){
+        .desired_max_size = MGA_MiB(1),
+        .desired_block_size = MGA_KiB(4),
+        .backend = MGA_BACKEND_MALLOC,
+        .error_callback = test_error_callback
+    });
+    TEST_ASSERT(malloc_arena != NULL, "malloc arena create");
+
+    // Fill most of the first node
+    mga_push(malloc_arena, MGA_KiB(3));
+
+    int mallocs_before = num_mallocs;
+    mga_u8* first = NULL;
+    for (int i = 0; i < 100; i++) {
+        mga_temp temp = mga_temp_begin(malloc_arena);
+        mga_push(temp.arena, 512);
+        mga_u8* data = (mga_u8*)mga_push(temp.arena, MGA_KiB(2));
+        TEST_ASSERT(data != NULL, "push across node");
+        data[MGA_KiB(2) - 1] = (mga_u8)i;
+
+        if (first == NULL) {
+            first = data;
+        }
+        TEST_ASSERT(data == first, "node reused");
+
+        mga_temp_end(temp);
+    }
+    TEST_ASSERT(num_mallocs - mallocs_before == 1, "one malloc for all temps");
+
+    // Big nodes are freed right away
+    mga_temp temp = mga_temp_begin(malloc_arena);
+    mga_push(temp.arena, 512);
+    TEST_ASSERT(mga_push(temp.arena, MGA_KiB(64)) != NULL, "big push");
+    mga_temp_end(temp);
+    TEST_ASSERT(malloc_arena->_malloc_backend.num_free_nodes == 1, "big node not cached");
+
+    mga_reset(malloc_arena);
+    TEST_ASSERT(malloc_arena->_malloc_backend.num_free_nodes <= MGA_MALLOC_NODE_CACHE, "cache limit");
+
+    mga_destroy(malloc_arena);
+
+    return true;
+}
+
+bool test_cache_color(void) {
+    mga_desc desc = {
+        .desired_max_size = MGA_MiB(1),
+        .cache_color = true,
+        .error_callback = test_error_callback
+    };
+
+    mg_arena* arenas[3] = { 0 };
+    mga_u64 offsets[3] = { 0 };
+    for (int i = 0; i < 3; i++) {
+        desc.backend = i == 2 ? MGA_BACKEND_MALLOC : MGA_BACKEND_RESERVE;
+        arenas[i] = mga_create(&desc);
+        TEST_ASSERT(arenas[i] != NULL, "colored create");
+
+        offsets[i] = mga_get_pos(arenas[i]) - (i == 2 ? 0 : MGA_MIN_POS);
+        TEST_ASSERT(offsets[i] % MGA_CACHE_LINE == 0, "colored line offset");
+        TEST_ASSERT(offsets[i] < MGA_CACHE_COLORS * MGA_CACHE_LINE, "colored max offset");
+
+        TEST_ASSERT(mga_push(arenas[i], 16) != NULL, "colored push");
+    }
+    TEST_ASSERT(offsets[0] != offsets[1] && offsets[1] != offsets[2], "different colors");
+
+    for (int i = 0; i < 3; i++) {
+        mga_u64 start_pos = arenas[i]->_start_pos;
+        mga_reset(arenas[i]);
+        TEST_ASSERT(mga_get_pos(arenas[i]) == start_pos, "colored reset");
+
+        mga_pop(arenas[i], 1);
+        TEST_ASSERT(mga_get_error(arenas[i]).code == MGA_ERR_CANNOT_POP_MORE, "colored pop");
+
+        mga_destroy(arenas[i]);
+    }
+
+    return true;
+}
+
+static mga_u32 custom_commits = 0;
+static mga_u32 custom_releases = 0;
+
+static void* custom_reserve(mga_u64 size) { return malloc(size); }
+static mga_b32 custom_commit(void* ptr, mga_u64 size) {
+    MGA_UNUSED(ptr); MGA_UNUSED(size);
+    custom_commits++;
+    return MGA_TRUE;
+}
+static void custom_decommit(void* ptr, mga_u64 size) { MGA_UNUSED(ptr); MGA_UNUSED(size); }
+static void custom_release(void* ptr, mga_u64 size) {
+    MGA_UNUSED(size);
+    custom_releases++;
+    free(ptr);
+}
+
+bool test_backends(void) {
+    mga_desc desc = {
+        .desired_max_size = MGA_MiB(1),
+        .desired_block_size = MGA_KiB(64),
+        .error_callback = test_error_callback
+    };
+
+    // Both backends are available in the same program
+    desc.backend = MGA_BACKEND_MALLOC;
+    mg_arena* malloc_arena = mga_create(&desc);
+    TEST_ASSERT(malloc_arena != NULL, "malloc backend create");
+    TEST_ASSERT(mga_push_top(malloc_arena, 16) == NULL, "malloc backend top");
+    TEST_ASSERT(mga_get_error(malloc_arena).code == MGA_ERR_UNSUPPORTED, "malloc backend top error");
+
+    desc.backend = MGA_BACKEND_RESERVE;
+    mg_arena* reserve_arena = mga_create(&desc);
+    TEST_ASSERT(reserve_arena != NULL, "reserve backend create");
+    TEST_ASSERT(mga_push_top(reserve_arena, 16) != NULL, "reserve backend top");
+
+    mg_arena* arenas[2] = { malloc_arena, reserve_arena };
+    for (int i = 0; i < 2; i++) {
+        mg_arena* a = arenas[i];
+        mga_u64 start_pos = mga_get_pos(a);
+        mga_u8* data = (mga_u8*)mga_push(a, MGA_KiB(200));
+        TEST_ASSERT(data != NULL, "backend push");
+        data[MGA_KiB(200) - 1] = 1;
+        mga_pop_to(a, start_pos);
+        TEST_ASSERT(mga_get_pos(a) == start_pos, "backend pop");
+    }
+
+    mga_destroy(malloc_arena);
+    mga_destroy(reserve_arena);
+
+    mga_mem_funcs funcs = {
+        .reserve = custom_reserve,
+        .commit = custom_commit,
+        .decommit = custom_decommit,
+        .release = custom_release
+    };
+    desc.backend = MGA_BACKEND_CUSTOM;
+    desc.mem_funcs = &funcs;
+    mg_arena* custom_arena = mga_create(&desc);
+    TEST_ASSERT(custom_arena != NULL, "custom backend create");
+    TEST_ASSERT(custom_commits == 1, "custom initial commit");
+
+    TEST_ASSERT(mga_push(custom_arena, MGA_KiB(100)) != NULL, "custom push");
+    TEST_ASSERT(custom_commits == 2, "custom commit");
+
+    mga_destroy(custom_arena);
+    TEST_ASSERT(custom_releases == 1, "custom release");
+
+    funcs.decommit = NULL;
+    TEST_ASSERT(mga_create(&desc) == NULL, "custom backend missing function");
+
+    return true;
+}
+
+static mga_u8 static_buffer[MGA_KiB(16)];
+
+bool test_buffer(void) {
+    mga_u64 buffer_words[MGA_KiB(4) / sizeof(mga_u64)];
+
+    mg_arena* stack_arena = mga_create_from_buffer(&(mga_desc){
+        .align = sizeof(void*),
+        .error_callback = test_error_callback
+    }, buffer_words, sizeof(buffer_words));
+    TEST_ASSERT(stack_arena != NULL, "stack buffer create");
+    TEST_ASSERT((void*)stack_arena == (void*)buffer_words, "arena at buffer start");
+    TEST_ASSERT(mga_get_size(stack_arena) == sizeof(buffer_words), "buffer size");
+
+    mga_u64 start_pos = mga_get_pos(stack_arena);
+    int* nums = MGA_PUSH_ARRAY(stack_arena, int, 64);
+    TEST_ASSERT(nums != NULL, "buffer push");
+    TEST_ASSERT((mga_u8*)nums >= (mga_u8*)buffer_words &&
+        (mga_u8*)(nums + 64) <= (mga_u8*)buffer_words + sizeof(buffer_words), "buffer bounds");
+    for (int i = 0; i < 64; i++) {
+        nums[i] = i;
+    }
+
+    int* top = MGA_PUSH_TOP_ARRAY(stack_arena, int, 16);
+    TEST_ASSERT(top != NULL, "buffer push top");
+    TEST_ASSERT((mga_u8*)(top + 16) <= (mga_u8*)buffer_words + sizeof(buffer_words), "buffer top bounds");
+
+    TEST_ASSERT(mga_push(stack_arena, sizeof(buffer_words)) == NULL, "buffer out of memory");
+    TEST_ASSERT(mga_get_error(stack_arena).code == MGA_ERR_OUT_OF_MEMORY, "buffer out of memory error");
+    TEST_ASSERT(mga_push_zero(stack_arena, sizeof(buffer_words)) == NULL, "buffer push zero out of memory");
+    TEST_ASSERT(nums[63] == 63, "buffer data kept");
+
+    mga_reset(stack_arena);
+    TEST_ASSERT(mga_get_pos(stack_arena) == start_pos, "buffer reset");
+    TEST_ASSERT(mga_get_top_pos(stack_arena) == mga_get_size(stack_arena), "buffer reset top");
+
+    // Destroying a buffer arena does not touch the buffer
+    mga_destroy(stack_arena);
+
+    // Unaligned buffers are aligned for the arena struct
+    mg_arena* static_arena = mga_create_from_buffer(&(mga_desc){
+        .error_callback = test_error_callback
+    }, static_buffer + 1, sizeof(static_buffer) - 1);
+    TEST_ASSERT(static_arena != NULL, "static buffer create");
+    TEST_ASSERT(((uintptr_t)static_arena & (sizeof(void*) - 1)) == 0, "static buffer align");
+    TEST_ASSERT(mga_push_zero(static_arena, MGA_KiB(8)) != NULL, "static buffer push");
+    mga_destroy(static_arena);
+
+    // Intern entries keep their own alignment in arenas with a smaller one
+    mg_arena* byte_arena = mga_create_from_buffer(&(mga_desc){
+        .align = 1,
+        .error_callback = test_error_callback
+    }, static_buffer, sizeof(static_buffer));
+    TEST_ASSERT(byte_arena != NULL, "byte aligned buffer create");
+    mga_intern_table* table = mga_intern_table_create(byte_arena, 4);
+    TEST_ASSERT(table != NULL, "byte aligned intern table");
+    for (int i = 0; i < 8; i++) {
+        mga_push(byte_arena, 1);
+        const mga_interned* entry = mga_intern(table, i % 2 ? MGA_STR8("odd") : MGA_STR8("even!"));
+        TEST_ASSERT(entry != NULL, "byte aligned intern");
+        TEST_ASSERT(((uintptr_t)entry & (_Alignof(mga_interned) - 1)) == 0, "intern entry align");
+    }
+    mga_destroy(byte_arena);
+
+    mga_u8 small_buffer[16];
+    TEST_ASSERT(mga_create_from_buffer(&(mga_desc){
+        .error_callback = test_error_callback
+    }, small_buffer, sizeof(small_buffer)) == NULL, "small buffer");
+
+    return true;
+}
+
+bool test_sub(void) {
+    mga_temp temp = mga_temp_begin(arena);
+
+    mg_arena* sub0 = mga_create_sub(temp.arena, MGA_KiB(16));
+    mg_arena* sub1 = mga_create_sub(temp.arena, MGA_KiB(16));
+    TEST_ASSERT(sub0 != NULL && sub1 != NULL, "sub create");
+    TEST_ASSERT(sub0->error_callback == arena->error_callback, "sub error callback");
+    TEST_ASSERT(mga_get_align(sub0) == mga_get_align(arena), "sub align");
+
+    // Both sub arenas are next to each other in the parent
+    TEST_ASSERT((mga_u8*)sub1 >= (mga_u8*)sub0 + mga_get_size(sub0), "sub layout");
+    TEST_ASSERT((mga_u64)((mga_u8*)sub1 - (mga_u8*)sub0) < mga_get_size(sub0) + 64, "sub contiguous");
+
+    int* nums0 = MGA_PUSH_ARRAY(sub0, int, 1024);
+    int* nums1 = MGA_PUSH_ARRAY(sub1, int, 1024);
+    TEST_ASSERT(nums0 != NULL && nums1 != NULL, "sub push");
+    for (int i = 0; i < 1024; i++) {
+        nums0[i] = i;
+        nums1[i] = -i;
+    }
+    TEST_ASSERT(nums0[1023] == 1023 && nums1[1023] == -1023, "sub data");
+
+    TEST_ASSERT(mga_push(sub0, MGA_KiB(16)) == NULL, "sub out of memory");
+    TEST_ASSERT(mga_get_error(sub0).code == MGA_ERR_OUT_OF_MEMORY, "sub out of memory error");
+
+    mg_arena* nested = mga_create_sub(sub1, MGA_KiB(4));
+    TEST_ASSERT(nested != NULL && MGA_PUSH_ZERO_ARRAY(nested, int, 512) != NULL, "nested sub");
+
+    TEST_ASSERT(mga_create_sub(sub1, MGA_KiB(64)) == NULL, "sub too large");
+    TEST_ASSERT(mga_get_error(sub1).code == MGA_ERR_OUT_OF_MEMORY, "sub too large error");
+
+    // Releases every sub arena at once
+    mga_temp_end(temp);
+    TEST_ASSERT(mga_get_pos(arena) == temp._pos, "sub release");
+
+    return true;
+}
+
+bool test_slot_map(void) {
+    mga_temp temp = mga_temp_begin(arena);
+    // Positions and addresses are contiguous in a sub arena, for every backend
+    mg_arena* sub = mga_create_sub(temp.arena, MGA_KiB(16));
+
+    int* nums = MGA_PUSH_ARRAY(sub, int, 16);
+    TEST_ASSERT(mga_extend(sub, nums, sizeof(int) * 16, sizeof(int) * 32), "extend last allocation");
+    TEST_ASSERT(!mga_extend(sub, nums, sizeof(int) * 16, sizeof(int) * 64), "extend not last allocation");
+
+    mga_slot_map* map = MGA_SLOT_MAP_CREATE(sub, mga_u64, 4);
+    TEST_ASSERT(map != NULL && mga_slot_map_count(map) == 0, "slot map create");
+    void* first_data = mga_slot_map_data(map);
+
+    mga_slot_handle handles[64];
+    for (mga_u64 i = 0; i < 64; i++) {
+        handles[i] = mga_slot_map_insert(map, &i);
+        TEST_ASSERT(handles[i].generation != 0, "slot map insert");
+    }
+    TEST_ASSERT(mga_slot_map_count(map) == 64, "slot map count");
+
+    // Nothing else was pushed, so the map grew in place
+    TEST_ASSERT(mga_slot_map_data(map) == first_data, "slot map grow in place");
+
+    for (mga_u64 i = 0; i < 64; i++) {
+        mga_u64* elem = MGA_SLOT_MAP_GET(map, mga_u64, handles[i]);
+        TEST_ASSERT(elem != NULL && *elem == i, "slot map get");
+    }
+
+    for (mga_u64 i = 0; i < 64; i += 2) {
+        TEST_ASSERT(mga_slot_map_remove(map, handles[i]), "slot map remove");
+    }
+    TEST_ASSERT(mga_slot_map_count(map) == 32, "slot map count after remove");
+    TEST_ASSERT(!mga_slot_map_remove(map, handles[0]), "slot map remove twice");
+
+    for (mga_u64 i = 0; i < 64; i++) {
+        mga_u64* elem = MGA_SLOT_MAP_GET(map, mga_u64, handles[i]);
+        if (i % 2 == 0) {
+            TEST_ASSERT(elem == NULL, "slot map stale handle");
+        } else {
+            TEST_ASSERT(elem != NULL && *elem == i, "slot map get after remove");
+        }
+    }
+
+    // Dense iteration, every element has a handle that points back to it
+    mga_u64* data = MGA_SLOT_MAP_DATA(map, mga_u64);
+    mga_u64 sum = 0;
+    for (mga_u32 i = 0; i < mga_slot_map_count(map); i++) {
+        sum += data[i];
+        TEST_ASSERT(mga_slot_map_get(map, mga_slot_map_handle_at(map, i)) == &data[i], "slot map handle at");
+    }
+    TEST_ASSERT(sum == 32 * 32, "slot map iterate");
+
+    // Removed slots are reused with a new generation
+    mga_u64 value = 100;
+    mga_slot_handle reused = mga_slot_map_insert(map, &value);
+    TEST_ASSERT(reused.index == handles[62].index && reused.generation != handles[62].generation, "slot map reuse");
+    TEST_ASSERT(mga_slot_map_get(map, handles[62]) == NULL, "slot map reused stale handle");
+
+    mga_slot_map_clear(map);
+    TEST_ASSERT(mga_slot_map_count(map) == 0, "slot map clear");
+    TEST_ASSERT(mga_slot_map_get(map, reused) == NULL && mga_slot_map_get(map, handles[1]) == NULL, "slot map clear handles");
+    TEST_ASSERT(mga_slot_map_get(map, (mga_slot_handle){ 0 }) == NULL, "slot map zero handle");
+
+    // Grows by copying when something else is on top
+    MGA_PUSH_STRUCT(sub, int);
+    for (mga_u64 i = 0; i < 128; i++) {
+        handles[i % 64] = mga_slot_map_insert(map, NULL);
+    }
+    TEST_ASSERT(mga_slot_map_count(map) == 128 && mga_slot_map_data(map) != first_data, "slot map grow copy");
+    TEST_ASSERT(*MGA_SLOT_MAP_GET(map, mga_u64, handles[63]) == 0, "slot map zero insert");
+
+    mga_temp_end(temp);
+
+    return true;
+}
+
+bool test_bucket_array(void) {
+    mga_temp temp = mga_temp_begin(arena);
+
+    mga_bucket_array* arr = MGA_BUCKET_ARRAY_CREATE(temp.arena, mga_u64, 16);
+    TEST_ASSERT(arr != NULL && mga_bucket_array_count(arr) == 0, "bucket array create");
+    TEST_ASSERT(mga_bucket_array_first(arr) == NULL, "bucket array empty");
+
+    mga_u64* ptrs[200];
+    for (mga_u64 i = 0; i < 200; i++) {
+        ptrs[i] = MGA_BUCKET_ARRAY_PUSH(arr, mga_u64, &i);
+        TEST_ASSERT(ptrs[i] != NULL, "bucket array push");
+
+        // Other allocations between the buckets
+        MGA_PUSH_STRUCT(temp.arena, mga_u64);
+    }
+    TEST_ASSERT(mga_bucket_array_count(arr) == 200, "bucket array count");
+
+    // Elements are never moved
+    for (mga_u64 i = 0; i < 200; i++) {
+        TEST_ASSERT(*ptrs[i] == i, "bucket array stable pointers");
+    }
+
+    mga_u64 expected = 0;
+    mga_u32 num_buckets = 0;
+    for (mga_bucket* b = mga_bucket_array_first(arr); b != NULL; b = mga_bucket_next(b)) {
+        mga_u64* elems = (mga_u64*)b->data;
+        TEST_ASSERT(b->count <= 16, "bucket array bucket size");
+
+        for (mga_u32 i = 0; i < b->count; i++) {
+            TEST_ASSERT(elems[i] == expected, "bucket array iterate order");
+            expected++;
+        }
+
+        num_buckets++;
+    }
+    TEST_ASSERT(expected == 200 && num_buckets == 13, "bucket array iterate");
+
+    mga_u64* zero = MGA_BUCKET_ARRAY_PUSH(arr, mga_u64, NULL);
+    TEST_ASSERT(zero != NULL && *zero == 0, "bucket array zero push");
+
+    mga_temp_end(temp);
+
+    return true;
+}
+
+bool test_strings(void) {
+    mga_temp temp = mga_temp_begin(arena);
+
+    mga_str8_builder builder = mga_str8_builder_begin(temp.arena);
+    TEST_ASSERT(mga_str8_append(&builder, MGA_STR8("x = ")), "str8 append");
+    TEST_ASSERT(mga_str8_append_i64(&builder, -42), "str8 append i64");
+    TEST_ASSERT(mga_str8_append(&builder, MGA_STR8(", ")), "str8 append 2");
+    TEST_ASSERT(mga_str8_append_u64(&builder, UINT64_MAX), "str8 append u64");
+    TEST_ASSERT(mga_str8_appendf(&builder, ", %.2f", 1.5), "str8 appendf");
+    mga_str8 str = mga_str8_builder_end(&builder);
+
+    TEST_ASSERT(mga_str8_equal(str, MGA_STR8("x = -42, 18446744073709551615, 1.50")), "str8 builder");
+    // Everything was appended in place
+    TEST_ASSERT(str.str + str.size == (mga_u8*)temp.arena->_fast_base + mga_get_pos(temp.arena), "str8 builder in place");
+
+    builder = mga_str8_builder_begin(temp.arena);
+    mga_str8_append_i64(&builder, INT64_MIN);
+    TEST_ASSERT(mga_str8_equal(mga_str8_builder_end(&builder), MGA_STR8("-9223372036854775808")), "str8 i64 min");
+
+    // The builder moves when something else is pushed
+    builder = mga_str8_builder_begin(temp.arena);
+    mga_str8_append(&builder, MGA_STR8("abc"));
+    MGA_PUSH_STRUCT(temp.arena, int);
+    mga_str8_appendf(&builder, "%d%s", 123, "def");
+    TEST_ASSERT(mga_str8_equal(mga_str8_builder_end(&builder), MGA_STR8("abc123def")), "str8 builder moved");
+
+    // Longer than the rest of the committed memory
+    builder = mga_str8_builder_begin(temp.arena);
+    mga_str8_appendf(&builder, "%*d", (int)MGA_KiB(300), 7);
+    str = mga_str8_builder_end(&builder);
+    TEST_ASSERT(str.size == MGA_KiB(300) && str.str[str.size - 1] == '7', "str8 appendf large");
+
+    TEST_ASSERT(mga_str8_hash(MGA_STR8("label")) == mga_str8_hash(mga_str8_from_cstr("label")), "str8 hash");
+    TEST_ASSERT(mga_str8_hash(MGA_STR8("label 1")) != mga_str8_hash(MGA_STR8("label 2")), "str8 hash different");
+
+    mga_intern_table* table = mga_intern_table_create(temp.arena, 4);
+    TEST_ASSERT(table != NULL, "intern table create");
+
+    const mga_interned* a = mga_intern(table, MGA_STR8("Line 1"));
+    const mga_interned* b = mga_intern(table, mga_str8_from_cstr("Line 1"));
+    const mga_interned* c = mga_intern(table, MGA_STR8("Line 2"));
+    TEST_ASSERT(a != NULL && a == b && a != c, "intern");
+    TEST_ASSERT(mga_str8_equal(a->str, MGA_STR8("Line 1")) && a->hash == mga_str8_hash(a->str), "intern copy");
+
+    // Growing the table does not move the strings
+    char name[32];
+    for (int i = 0; i < 100; i++) {
+        snprintf(name, sizeof(name), "tick %d", i);
+        mga_intern(table, mga_str8_from_cstr(name));
+    }
+    TEST_ASSERT(mga_intern_table_count(table) == 102, "intern count");
+    TEST_ASSERT(mga_intern(table, MGA_STR8("Line 1")) == a, "intern stable");
+    TEST_ASSERT(mga_intern_find(table, MGA_STR8("tick 50")) != NULL, "intern find");
+    TEST_ASSERT(mga_intern_find(table, MGA_STR8("tick 100")) == NULL, "intern find missing");
+    TEST_ASSERT(mga_intern(table, MGA_STR8("")) == mga_intern(table, (mga_str8){ 0 }), "intern empty");
+
+    mga_temp_end(temp);
+
+    return true;
+}
+
+static mga_b32 sum_chunk(void* user_data, const mga_u8* data, mga_u64 size) {
+    mga_u64* sum = (mga_u64*)user_data;
+    for (mga_u64 i = 0; i < size; i++) {
+        *sum += data[i];
+    }
+
+    return MGA_TRUE;
+}
+
+bool test_files(void) {
+    const char* path = "test_mga_file.tmp";
+
+    FILE* f = fopen(path, "wb");
+    TEST_ASSERT(f != NULL, "file create");
+
+    mga_u64 expected_sum = 0;
+    for (mga_u32 i = 0; i < 100000; i++) {
+        mga_u8 byte = (mga_u8)(i * 7);
+        expected_sum += byte;
+        fputc(byte, f);
+    }
+    fclose(f);
+
+    mga_temp temp = mga_temp_begin(arena);
+
+    mga_str8 contents = mga_read_file(temp.arena, path);
+    TEST_ASSERT(contents.str != NULL && contents.size == 100000, "read file");
+    TEST_ASSERT(contents.str[0] == 0 && contents.str[99999] == (mga_u8)(99999 * 7), "read file data");
+
+    mga_u64 pos = mga_get_pos(temp.arena);
+    mga_u64 sum = 0;
+    TEST_ASSERT(mga_read_file_chunks(temp.arena, path, MGA_KiB(4), sum_chunk, &sum), "read file chunks");
+    TEST_ASSERT(sum == expected_sum, "read file chunks data");
+    TEST_ASSERT(mga_get_pos(temp.arena) == pos, "read file chunks pop");
+
+    mga_file_view view = mga_file_view_open(path);
+    TEST_ASSERT(view.data != NULL && view.size == 100000, "file view");
+    TEST_ASSERT(memcmp(view.data, contents.str, view.size) == 0, "file view data");
+    mga_file_view_close(&view);
+    TEST_ASSERT(view.data == NULL, "file view close");
+
+    TEST_ASSERT(mga_read_file(temp.arena, "does_not_exist.tmp").str == NULL, "read missing file");
+    TEST_ASSERT(mga_get_error(temp.arena).code == MGA_ERR_FILE_FAILED, "read missing file error");
+
+    mga_temp_end(temp);
+
+    // Big enough for several reads in flight where io_uring is available
+    mga_u64 big_size = MGA_MiB(3) + 12345;
+    mg_arena* big_arena = mga_create(&(mga_desc){
+        .desired_max_size = MGA_MiB(8),
+        .error_callback = test_error_callback
+    });
+    TEST_ASSERT(big_arena != NULL, "big file arena create");
+
+    mga_u32* words = MGA_PUSH_ARRAY(big_arena, mga_u32, big_size / sizeof(mga_u32) + 1);
+    for (mga_u64 i = 0; i < big_size / sizeof(mga_u32) + 1; i++) {
+        words[i] = (mga_u32)(i * 2654435761u);
+    }
+    f = fopen(path, "wb");
+    TEST_ASSERT(f != NULL && fwrite(words, 1, big_size, f) == big_size, "big file write");
+    fclose(f);
+
+    mga_str8 big = mga_read_file(big_arena, path);
+    TEST_ASSERT(big.str != NULL && big.size == big_size, "read big file");
+    TEST_ASSERT(memcmp(big.str, words, big_size) == 0, "read big file data");
+    mga_destroy(big_arena);
+
+    remove(path);
+
+    return true;
+}
+
+bool test_timeline(void) {
+    mg_arena* recorded = mga_create(&(mga_desc){
+        .desired_max_size = MGA_MiB(1),
+        .desired_block_size = MGA_KiB(4),
+        .error_callback = test_error_callback
+    });
+    TEST_ASSERT(recorded != NULL, "timeline arena create");
+
+    TEST_ASSERT(mga_timeline_create(recorded, recorded, MGA_STR8("self")) == NULL, "timeline self storage");
+
+    mga_temp temp = mga_temp_begin(arena);
+
+    mga_timeline* timeline = mga_timeline_create(temp.arena, recorded, MGA_STR8("recorded"));
+    TEST_ASSERT(timeline != NULL, "timeline create");
+    TEST_ASSERT(mga_str8_equal(timeline->name, MGA_STR8("recorded")), "timeline name");
+    TEST_ASSERT(mga_bucket_array_count(timeline->samples) == 1, "timeline first sample");
+
+    mga_u64 start_pos = mga_get_pos(recorded);
+    mga_push(recorded, MGA_KiB(64));
+    mga_u64 num_samples = mga_bucket_array_count(timeline->samples);
+    TEST_ASSERT(num_samples > 1, "timeline commit sample");
+
+    mga_timeline_sample(timeline);
+    mga_sample* last = NULL;
+    mga_u64 prev_time = 0;
+    mga_b32 ordered = true;
+    for (mga_bucket* bucket = mga_bucket_array_first(timeline->samples); bucket != NULL; bucket = mga_bucket_next(bucket)) {
+        for (mga_u32 i = 0; i < bucket->count; i++) {
+            last = (mga_sample*)bucket->data + i;
+            ordered &= last->time >= prev_time;
+            prev_time = last->time;
+        }
+    }
+    TEST_ASSERT(ordered, "timeline sample order");
+    TEST_ASSERT(last->pos == mga_get_pos(recorded), "timeline sample pos");
+    TEST_ASSERT(last->committed == mga_get_committed(recorded), "timeline sample committed");
+    TEST_ASSERT(last->committed >= last->pos, "timeline committed pos");
+
+    mga_timeline_stop(timeline);
+    num_samples = mga_bucket_array_count(timeline->samples);
+    mga_pop_to(recorded, start_pos);
+    mga_push(recorded, MGA_KiB(128));
+    TEST_ASSERT(mga_bucket_array_count(timeline->samples) == num_samples, "timeline stop");
+
+    mga_temp_end(temp);
+    mga_destroy(recorded);
+
+    return true;
+}
+
+typedef struct rel_node {
+    mga_u32 value;
+    mga_rel_ptr next;
+} rel_node;
+
+static mga_b32 check_rel_list(const rel_node* node, mga_u32 num_nodes) {
+    for (mga_u32 i = 0; i < num_nodes; i++) {
+        if (node == NULL || node->value != i) {
+            return false;
+        }
+
+        node = MGA_REL_GET(const rel_node, node->next);
+    }
+
+    return node == NULL;
+}
+
+bool test_save_load(void) {
+    const char* path = "test_mga_save.tmp";
+
+    mg_arena* saved = mga_create(&(mga_desc){
+        .desired_max_size = MGA_MiB(1),
+        .error_callback = test_error_callback
+    });
+    TEST_ASSERT(saved != NULL, "save arena create");
+
+    mga_u64 start_pos = mga_get_pos(saved);
+    rel_node* head = MGA_PUSH_ZERO_STRUCT(saved, rel_node);
+    mga_u64 align_offset = (mga_u64)(uintptr_t)head % MGA_CACHE_LINE;
+    rel_node* node = head;
+    for (mga_u32 i = 1; i < 100; i++) {
+        rel_node* next = MGA_PUSH_ZERO_STRUCT(saved, rel_node);
+        next->value = i;
+
+        MGA_REL_SET(node->next, next);
+        node = next;
+    }
+    MGA_REL_SET(node->next, NULL);
+    TEST_ASSERT(node->next == 0 && check_rel_list(head, 100), "rel ptr list");
+
+    TEST_ASSERT(mga_save(saved, path), "save");
+
+    mga_temp temp = mga_temp_begin(arena);
+    mga_push(temp.arena, 3);
+
+    mga_u64 size = 0;
+    rel_node* loaded = (rel_node*)mga_load(temp.arena, path, &size);
+    TEST_ASSERT(loaded != NULL && loaded != head, "load");
+    TEST_ASSERT(size == mga_get_pos(saved) - start_pos, "load size");
+    TEST_ASSERT((mga_u64)(uintptr_t)loaded % MGA_CACHE_LINE == align_offset, "load align");
+    TEST_ASSERT(check_rel_list(loaded, 100), "load rel ptrs");
+
+    // The data follows a header, at the same offset from a cache line
+    mga_file_view view = mga_file_view_open(path);
+    const rel_node* view_head = (const rel_node*)(view.data + MGA_CACHE_LINE + align_offset);
+    TEST_ASSERT(view.size == MGA_CACHE_LINE + align_offset + size, "file view size");
+    TEST_ASSERT(check_rel_list(view_head, 100), "file view rel ptrs");
+    mga_file_view_close(&view);
+
+    TEST_ASSERT(mga_load(temp.arena, "does_not_exist.tmp", NULL) == NULL, "load missing file");
+
+    FILE* f = fopen(path, "wb");
+    TEST_ASSERT(f != NULL, "invalid save create");
+    fputs("not a save file, but long enough for a header", f);
+    fclose(f);
+    TEST_ASSERT(mga_load(temp.arena, path, &size) == NULL && size == 0, "load invalid file");
+    TEST_ASSERT(mga_get_error(temp.arena).code == MGA_ERR_FILE_FAILED, "load invalid file error");
+
+    mga_temp_end(temp);
+    mga_destroy(saved);
+
+    mg_arena* malloc_arena = mga_create(&(mga_desc){
+        .desired_max_size = MGA_MiB(1),
+        .desired_block_size = MGA_KiB(4),
+        .backend = MGA_BACKEND_MALLOC,
+        .error_callback = test_error_callback
+    });
+    TEST_ASSERT(malloc_arena != NULL, "save malloc arena create");
+
+    // Malloc arenas do not start on a cache line, the loaded data has to keep the offset
+    rel_node* malloc_head = (rel_node*)mga_push_zero(malloc_arena, sizeof(rel_node) * 8);
+    for (mga_u32 i = 0; i < 8; i++) {
+        malloc_head[i].value = i;
+        MGA_REL_SET(malloc_head[i].next, i == 7 ? NULL : &malloc_head[i + 1]);
+    }
+    TEST_ASSERT(mga_save(malloc_arena, path), "save malloc arena");
+
+    temp = mga_temp_begin(arena);
+    loaded = (rel_node*)mga_load(temp.arena, path, &size);
+    TEST_ASSERT(loaded != NULL && check_rel_list(loaded, 8), "load malloc arena");
+    TEST_ASSERT((uintptr_t)loaded % MGA_CACHE_LINE == (uintptr_t)malloc_head % MGA_CACHE_LINE, "load malloc arena align");
+    mga_temp_end(temp);
+
+    mga_push(malloc_arena, MGA_KiB(16));
+    TEST_ASSERT(!mga_save(malloc_arena, path), "save malloc nodes");
+    TEST_ASSERT(mga_get_error(malloc_arena).code == MGA_ERR_UNSUPPORTED, "save malloc nodes error");
+    mga_destroy(malloc_arena);
+
+    remove(path);
+
+    return true;
+}
+
+bool test_sort(void) {
+    #define SORT_COUNT 10000
+
+    mga_temp temp = mga_temp_begin(arena);
+
+    mga_u32* keys = MGA_PUSH_ARRAY(temp.arena, mga_u32, SORT_COUNT);
+    mga_u32* values = MGA_PUSH_ARRAY(temp.arena, mga_u32, SORT_COUNT);
+
+    mga_u32 state = 12345;
+    for (mga_u32 i = 0; i < SORT_COUNT; i++) {
+        state = state * 1664525u + 1013904223u;
+        // Only 256 different keys, so the sort has to be stable
+        keys[i] = state & 0xff00ff00;
+        values[i] = i;
+    }
+
+    TEST_ASSERT(mga_radix_sort_u32(keys, values, SORT_COUNT), "radix sort u32");
+    mga_b32 sorted = true;
+    for (mga_u32 i = 1; i < SORT_COUNT; i++) {
+        sorted &= keys[i - 1] < keys[i] || (keys[i - 1] == keys[i] && values[i - 1] < values[i]);
+    }
+    TEST_ASSERT(sorted, "radix sort u32 stable");
+
+    mga_i32* ints = (mga_i32*)keys;
+    for (mga_u32 i = 0; i < SORT_COUNT; i++) {
+        state = state * 1664525u + 1013904223u;
+        ints[i] = (mga_i32)state;
+    }
+    TEST_ASSERT(mga_radix_sort_i32(ints, NULL, SORT_COUNT), "radix sort i32");
+    sorted = true;
+    for (mga_u32 i = 1; i < SORT_COUNT; i++) {
+        sorted &= ints[i - 1] <= ints[i];
+    }
+    TEST_ASSERT(sorted, "radix sort i32 order");
+
+    float* floats = MGA_PUSH_ARRAY(temp.arena, float, SORT_COUNT);
+    for (mga_u32 i = 0; i < SORT_COUNT; i++) {
+        state = state * 1664525u + 1013904223u;
+        floats[i] = ((float)(state >> 8) / (float)(1 << 24) - 0.5f) * 1000.0f;
+        values[i] = i;
+    }
+    floats[0] = -0.0f;
+    floats[1] = 0.0f;
+    float first = floats[2];
+    TEST_ASSERT(mga_radix_sort_f32(floats, values, SORT_COUNT), "radix sort f32");
+    sorted = true;
+    mga_b32 values_match = false;
+    for (mga_u32 i = 1; i < SORT_COUNT; i++) {
+        sorted &= floats[i - 1] <= floats[i];
+    }
+    for (mga_u32 i = 0; i < SORT_COUNT; i++) {
+        values_match |= values[i] == 2 && floats[i] == first;
+    }
+    TEST_ASSERT(sorted && values_match, "radix sort f32 order");
+
+    for (mga_u32 i = 0; i < SORT_COUNT; i++) {
+        keys[i] = 1;
+        floats[i] = 0.5f;
+    }
+    mga_prefix_sum_u32(keys, SORT_COUNT);
+    mga_prefix_sum_f32(floats, SORT_COUNT);
+    TEST_ASSERT(keys[0] == 1 && keys[SORT_COUNT - 1] == SORT_COUNT, "prefix sum u32");
+    TEST_ASSERT(floats[SORT_COUNT - 1] == SORT_COUNT * 0.5f, "prefix sum f32");
+
+    mga_temp_end(temp);
+
+    // The sorts created scratch arenas, test_scratch needs to create its own
+    mga_scratch_destroy();
+
+    #undef SORT_COUNT
+
+    return true;
+}
+
 bool test_destroy(void) {
     // I guess this only fails if there is a seg fault
     mga_destroy(arena);
@@ -191,6 +1120,155 @@ bool test_scratch(void) {
     TEST_ASSERT(mga_get_pos(scratch0.arena) == spos0, "scratch release");
     TEST_ASSERT(mga_get_pos(scratch1.arena) == spos1, "scratch release");
 
+    // Arenas in use are skipped without a conflict list
+    mga_scratch_set_count(4);
+    mga_temp nested[4];
+    for (int i = 0; i < 4; i++) {
+        nested[i] = mga_scratch_get(NULL, 0);
+        TEST_ASSERT(nested[i].arena != NULL, "nested scratch");
+        for (int j = 0; j < i; j++) {
+            TEST_ASSERT(nested[i].arena != nested[j].arena, "nested scratch distinct");
+        }
+    }
+    TEST_ASSERT(nested[0].arena == scratch0.arena, "scratch reused");
+    for (int i = 3; i >= 0; i--) {
+        mga_scratch_release(nested[i]);
+    }
+
+    // When every arena is in use, the deepest one is shared
+    mga_scratch_set_count(2);
+    mga_temp outer0 = mga_scratch_get(NULL, 0);
+    mga_temp outer1 = mga_scratch_get(NULL, 0);
+    mga_temp shared = mga_scratch_get(&outer0.arena, 1);
+    TEST_ASSERT(shared.arena == outer1.arena, "scratch shared");
+    TEST_ASSERT(mga_scratch_get((mg_arena*[]){ outer0.arena, outer1.arena }, 2).arena == NULL, "scratch all conflicts");
+    mga_scratch_release(shared);
+    mga_scratch_release(outer1);
+    mga_scratch_release(outer0);
+
+    mga_temp after = mga_scratch_get(NULL, 0);
+    TEST_ASSERT(after.arena == outer0.arena, "scratch released bits");
+    mga_scratch_release(after);
+
+    mga_scratch_set_count(MGA_SCRATCH_COUNT);
+
+    return true;
+}
+
+static void* scratch_thread_func(void* arg) {
+    mga_scratch_set_desc(&(mga_desc){
+        .desired_max_size = MGA_MiB(1),
+        .backend = MGA_BACKEND_CUSTOM,
+        .mem_funcs = (mga_mem_funcs*)arg
+    });
+
+    mga_temp scratch0 = mga_scratch_get(NULL, 0);
+    mga_temp scratch1 = mga_scratch_get(NULL, 0);
+    mga_push(scratch1.arena, 1024);
+    mga_scratch_release(scratch1);
+    mga_scratch_release(scratch0);
+
+    return NULL;
+}
+
+bool test_scratch_cleanup(void) {
+    mga_scratch_reset_peak();
+
+    mga_temp scratch = mga_scratch_get(NULL, 0);
+    mga_u64 start_pos = mga_get_pos(scratch.arena);
+    TEST_ASSERT(mga_push(scratch.arena, MGA_KiB(300)) != NULL, "scratch push");
+    mga_scratch_release(scratch);
+
+    TEST_ASSERT(mga_scratch_get_peak() >= MGA_KiB(300), "scratch peak");
+    TEST_ASSERT(mga_get_pos(scratch.arena) == start_pos, "scratch release");
+
+#ifndef MGA_FORCE_MALLOC
+    mga_u64 retained = scratch.arena->_reserve_backend.commit_pos;
+    TEST_ASSERT(retained >= start_pos + MGA_KiB(300), "scratch retains commit");
+
+    mga_scratch_shrink();
+    TEST_ASSERT(scratch.arena->_reserve_backend.commit_pos < retained, "scratch shrink");
+#else
+    mga_scratch_shrink();
+    TEST_ASSERT(scratch.arena->_malloc_backend.num_free_nodes == 0, "scratch shrink");
+#endif
+
+    // Scratch memory is still usable after shrinking
+    scratch = mga_scratch_get(NULL, 0);
+    TEST_ASSERT(mga_push_zero(scratch.arena, MGA_KiB(300)) != NULL, "scratch push after shrink");
+    mga_scratch_release(scratch);
+
+    mga_mem_funcs funcs = {
+        .reserve = custom_reserve,
+        .commit = custom_commit,
+        .decommit = custom_decommit,
+        .release = custom_release
+    };
+    mga_u32 releases = custom_releases;
+
+    pthread_t thread;
+    pthread_create(&thread, NULL, scratch_thread_func, &funcs);
+    pthread_join(thread, NULL);
+
+#ifndef MGA_NO_SCRATCH_CLEANUP
+    TEST_ASSERT(custom_releases - releases == 2, "scratch thread exit");
+#else
+    MGA_UNUSED(releases);
+#endif
+
+    return true;
+}
+
+bool test_ring(void) {
+    mga_ring* ring = mga_ring_create(&(mga_ring_desc){
+        .desired_size = MGA_KiB(4),
+        .error_callback = test_error_callback
+    });
+    TEST_ASSERT(ring != NULL, "ring create");
+
+    mga_u64 size = mga_ring_get_size(ring);
+    TEST_ASSERT(IS_POW2(size) && size >= MGA_KiB(4), "ring size");
+    TEST_ASSERT(mga_ring_get_free(ring) == size, "ring free");
+
+    mga_u64 record_size = size / 4 + 8;
+    mga_u8 value = 0;
+    // Enough records to wrap around the end several times
+    for (int i = 0; i < 16; i++) {
+        mga_u8* record = (mga_u8*)mga_ring_push(ring, record_size);
+        TEST_ASSERT(record != NULL, "ring push");
+        for (mga_u64 j = 0; j < record_size; j++) {
+            record[j] = value++;
+        }
+        mga_ring_publish(ring);
+
+        mga_u64 available = 0;
+        mga_u8* data = (mga_u8*)mga_ring_peek(ring, &available);
+        TEST_ASSERT(data == record && available == record_size, "ring peek");
+        for (mga_u64 j = 0; j < record_size; j++) {
+            TEST_ASSERT(data[j] == (mga_u8)(value - record_size + j), "ring contiguous");
+        }
+
+        mga_ring_release(ring, record_size);
+    }
+
+    TEST_ASSERT(mga_ring_push(ring, size + 1) == NULL, "ring full");
+    TEST_ASSERT(mga_ring_get_producer_error(ring).code == MGA_ERR_OUT_OF_MEMORY, "ring full error");
+    TEST_ASSERT(mga_ring_get_producer_error(ring).code == MGA_ERR_NONE, "ring producer error cleared");
+
+    mga_ring_release(ring, MGA_KiB(4));
+    TEST_ASSERT(mga_ring_get_consumer_error(ring).code == MGA_ERR_CANNOT_POP_MORE, "ring consumer error");
+
+    mga_ring_push(ring, size + 1);
+    TEST_ASSERT(mga_ring_get_error(ring).code == MGA_ERR_OUT_OF_MEMORY, "ring error");
+
+    mga_ring_destroy(ring);
+
+    TEST_ASSERT(mga_ring_create(&(mga_ring_desc){
+        .desired_size = MGA_KiB(4),
+        .align = 12,
+        .error_callback = test_error_callback
+    }) == NULL, "ring align not pow2");
+
     return true;
 }
 
@@ -201,8 +1279,27 @@ bool test_scratch(void) {
     X(GETTERS, getters) \
     X(POP, pop) \
     X(TEMP, temp) \
+    X(PREPARE, prepare) \
+    X(BATCH, batch) \
+    X(ALIGNED, aligned) \
+    X(COPY, copy) \
+    X(TOP, top) \
+    X(BUFFER, buffer) \
+    X(SUB, sub) \
+    X(SLOT_MAP, slot_map) \
+    X(BUCKET_ARRAY, bucket_array) \
+    X(STRINGS, strings) \
+    X(FILES, files) \
+    X(TIMELINE, timeline) \
+    X(SAVE_LOAD, save_load) \
+    X(SORT, sort) \
+    X(BACKENDS, backends) \
+    X(NODE_CACHE, node_cache) \
+    X(CACHE_COLOR, cache_color) \
     X(DESTROY, destroy) \
-    X(SCRATCH, scratch)
+    X(SCRATCH, scratch) \
+    X(SCRATCH_CLEANUP, scratch_cleanup) \
+    X(RING, ring)
 
 enum {
 #define X(name, func_name) TEST_##name,
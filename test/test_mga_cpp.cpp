@@ -0,0 +1,242 @@
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+
+#include <vector>
+#include <string>
+#include <unordered_map>
+
+#define MGA_STATIC
+#define MG_ARENA_IMPL
+#include "../mg_arena.h"
+#include "../mg_arena.hpp"
+
+#define TEST_ASSERT(b, m) \
+    if (!(b)) { printf("\x1b[35mAssert Failed: " m "\x1b[0m\n"); return false; }
+
+static mg_arena* arena;
+
+struct alignas(256) big_align {
+    float values[4];
+};
+
+void test_error_callback(mga_error err) { 
+    printf("MGA Error %u: %s\n", err.code, err.msg);
+}
+
+bool test_create(void) {
+    mga_desc desc = { };
+    desc.desired_max_size = MGA_MiB(16);
+    desc.error_callback = test_error_callback;
+
+    arena = mga_create(&desc);
+    TEST_ASSERT(arena != NULL, "Arena create");
+
+    return true;
+}
+
+struct vec3 {
+    float x, y, z;
+};
+
+struct counted {
+    int value;
+    std::string name;
+
+    counted() : value(7) { }
+    counted(int v, const char* n) : value(v), name(n) { }
+};
+
+bool test_push(void) {
+    mga_u64 start_pos = mga_get_pos(arena);
+
+    vec3* points = mga::push<vec3>(arena, 100);
+    TEST_ASSERT(points != NULL, "push array");
+    TEST_ASSERT(((uintptr_t)points % alignof(vec3)) == 0, "push alignment");
+
+    vec3* fixed = mga::push<vec3, 16>(arena);
+    TEST_ASSERT(fixed != NULL, "push constant count");
+    TEST_ASSERT(mga_get_pos(arena) - start_pos >= sizeof(vec3) * 116, "push sizes");
+
+    big_align* big = mga::push<big_align, 2>(arena);
+    TEST_ASSERT(((uintptr_t)big & 255) == 0, "push over aligned");
+
+    vec3* zeros = mga::push_zero<vec3>(arena, 8);
+    TEST_ASSERT(zeros[7].x == 0.0f && zeros[7].z == 0.0f, "push zero");
+
+    counted* objs = mga::push<counted>(arena, 4);
+    TEST_ASSERT(objs[3].value == 7 && objs[3].name.empty(), "push constructs");
+
+    counted* obj = mga::emplace<counted>(arena, 3, "three");
+    TEST_ASSERT(obj->value == 3 && obj->name == "three", "emplace");
+
+    mga_u64 pos = mga_get_pos(arena);
+    TEST_ASSERT(mga::push<vec3>(arena, SIZE_MAX / 4) == NULL, "push overflow");
+    TEST_ASSERT(mga_get_pos(arena) == pos, "overflow does not push");
+
+    // The arena does not call destructors
+    for (int i = 0; i < 4; i++) {
+        objs[i].~counted();
+    }
+    obj->~counted();
+
+    mga_pop_to(arena, start_pos);
+
+    return true;
+}
+
+bool test_allocator(void) {
+    mga_u64 start_pos = mga_get_pos(arena);
+
+    {
+        mga::allocator<int> alloc(arena);
+        std::vector<int, mga::allocator<int>> ints(alloc);
+        for (int i = 0; i < 1000; i++) {
+            ints.push_back(i);
+        }
+        TEST_ASSERT(ints[999] == 999, "vector push_back");
+        TEST_ASSERT(mga_get_pos(arena) > start_pos, "vector on arena");
+
+        typedef std::pair<const int, int> pair;
+        std::unordered_map<int, int, std::hash<int>, std::equal_to<int>, mga::allocator<pair>> map(
+            16, std::hash<int>(), std::equal_to<int>(), mga::allocator<pair>(arena)
+        );
+        for (int i = 0; i < 1000; i++) {
+            map[i] = i * 2;
+        }
+        TEST_ASSERT(map[500] == 1000, "unordered_map insert");
+
+        mga::allocator<big_align> big_alloc(alloc);
+        TEST_ASSERT(big_alloc == alloc, "rebound allocator equality");
+        big_align* big = big_alloc.allocate(3);
+        TEST_ASSERT(((uintptr_t)big & 255) == 0, "over aligned allocate");
+    }
+
+    mga_pop_to(arena, start_pos);
+
+    return true;
+}
+
+bool test_pmr(void) {
+#ifdef MGA_HAS_PMR
+    mga_u64 start_pos = mga_get_pos(arena);
+
+    {
+        mga::memory_resource resource(arena);
+
+        std::pmr::vector<std::pmr::string> strings(&resource);
+        for (int i = 0; i < 100; i++) {
+            strings.emplace_back("A string that is too long for the small string optimization");
+        }
+        TEST_ASSERT(strings[99].size() == 59, "pmr strings");
+        TEST_ASSERT(strings[99].get_allocator().resource() == &resource, "pmr propagation");
+
+        void* ptr = resource.allocate(64, 128);
+        TEST_ASSERT(((uintptr_t)ptr & 127) == 0, "pmr alignment");
+
+        mga::memory_resource other(arena);
+        TEST_ASSERT(!resource.is_equal(other), "pmr equality");
+    }
+
+    mga_pop_to(arena, start_pos);
+#endif
+
+    return true;
+}
+
+bool test_scopes(void) {
+    mga_u64 start_pos = mga_get_pos(arena);
+
+    {
+        mga::temp_scope temp(arena);
+        TEST_ASSERT(temp.arena() == arena, "temp arena");
+
+        mga_push(arena, 1024);
+        TEST_ASSERT(mga_get_pos(arena) > start_pos, "temp push");
+    }
+    TEST_ASSERT(mga_get_pos(arena) == start_pos, "temp scope end");
+
+    mg_arena* first = NULL;
+    mga_u64 first_pos = 0;
+    {
+        mga::scratch_scope scratch;
+        first = scratch.arena();
+        TEST_ASSERT(first != NULL, "scratch get");
+        first_pos = mga_get_pos(first);
+
+        mga_push(first, 1024);
+
+        mga::scratch_scope other({ first });
+        TEST_ASSERT(other.arena() != NULL && other.arena() != first, "scratch conflicts");
+
+        mga::scratch_scope none({ first, other.arena() });
+        TEST_ASSERT(none.arena() == NULL, "scratch all conflicts");
+    }
+    TEST_ASSERT(mga_get_pos(first) == first_pos, "scratch scope end");
+
+    return true;
+}
+
+bool test_destroy(void) {
+    mga_destroy(arena);
+
+    return true;
+}
+
+#define TEST_XLIST \
+    X(CREATE, create) \
+    X(PUSH, push) \
+    X(ALLOCATOR, allocator) \
+    X(PMR, pmr) \
+    X(SCOPES, scopes) \
+    X(DESTROY, destroy)
+
+enum {
+#define X(name, func_name) TEST_##name,
+    TEST_XLIST
+#undef X
+    TEST_COUNT
+};
+
+static const char* test_names[TEST_COUNT] = {
+#define X(name, func_name) #name,
+    TEST_XLIST
+#undef X
+};
+
+typedef bool (test_func)(void);
+static test_func* test_funcs[TEST_COUNT] = {
+#define X(name, func_name) test_##func_name,
+    TEST_XLIST
+#undef X
+};
+
+#define RED_BG(s) "\x1b[41m" s "\x1b[0m"
+#define GRN_BG(s) "\x1b[42m" s "\x1b[0m"
+
+int main(int argc, char** argv) {
+    bool quiet = false;
+    for (int i = 0; i < argc; i++) {
+        if (strcmp(argv[i], "-s") == 0)
+            quiet = true;
+    }
+
+    uint32_t num_passed = 0;
+    for (int i = 0; i < TEST_COUNT; i++) {
+        if (test_funcs[i]()) {
+            if (!quiet)
+                printf(GRN_BG("Test passed:") " %s\n", test_names[i]);
+            
+            num_passed++;
+        } else {
+            if (!quiet)
+                printf(RED_BG("Test failed:") " %s\n", test_names[i]);
+        }
+    }
+
+    if (!quiet) { puts(""); }
+    printf("Test Results: " GRN_BG("%d/%d passed") ", " RED_BG("%d/%d failed") ".\n",
+        num_passed, TEST_COUNT, TEST_COUNT - num_passed, TEST_COUNT);
+    
+    return 0;
+}
@@ -0,0 +1,221 @@
+#include <stdio.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#include <pthread.h>
+
+#define MG_ARENA_IMPL
+#include "../mg_arena.h"
+
+#define MGE_STATIC
+#define MG_EPOCH_IMPL
+#include "../mg_epoch.h"
+
+#define TEST_ASSERT(b, m) \
+    if (!(b)) { printf("\x1b[35mAssert Failed: " m "\x1b[0m\n"); return false; }
+
+static mg_arena* arena;
+static mge_domain* domain;
+
+void test_error_callback(mga_error err) { 
+    printf("MGA Error %u: %s\n", err.code, err.msg);
+}
+
+bool test_create(void) {
+    arena = mga_create(&(mga_desc){
+        .desired_max_size = MGA_MiB(1),
+        .error_callback = test_error_callback
+    });
+    TEST_ASSERT(arena != NULL, "Arena create");
+
+    domain = mge_create(arena, &(mge_desc){
+        .max_readers = 8,
+        .arena_desc = {
+            .desired_max_size = MGA_MiB(4),
+            .error_callback = test_error_callback
+        }
+    });
+    TEST_ASSERT(domain != NULL, "Domain create");
+    TEST_ASSERT(mge_get_epoch(domain) == 0, "Initial epoch");
+
+    return true;
+}
+
+bool test_advance(void) {
+    mga_u32 reader = mge_reader_register(domain);
+    TEST_ASSERT(reader != MGE_INVALID_READER, "register");
+
+    mga_u64 epoch = mge_get_epoch(domain);
+    mg_arena* epoch_arena = mge_get_arena(domain);
+    mga_u64 start_pos = mga_get_pos(epoch_arena);
+    TEST_ASSERT(mga_push(epoch_arena, 256) != NULL, "epoch push");
+
+    mge_pin(domain, reader);
+    TEST_ASSERT(mge_try_advance(domain), "advance with reader in current epoch");
+    TEST_ASSERT(mge_get_epoch(domain) == epoch + 1, "advanced");
+    TEST_ASSERT(!mge_try_advance(domain), "reader blocks advance");
+    mge_unpin(domain, reader);
+
+    TEST_ASSERT(mge_try_advance(domain), "advance after unpin");
+    TEST_ASSERT(mga_get_pos(epoch_arena) != start_pos, "old epoch kept");
+    TEST_ASSERT(mge_try_advance(domain), "advance again");
+    TEST_ASSERT(mge_get_arena(domain) == epoch_arena, "arena reused");
+    TEST_ASSERT(mga_get_pos(epoch_arena) == start_pos, "arena reset");
+
+    mge_reader_unregister(domain, reader);
+
+    mga_u32 readers[8];
+    for (int i = 0; i < 8; i++) {
+        readers[i] = mge_reader_register(domain);
+        TEST_ASSERT(readers[i] != MGE_INVALID_READER, "register all");
+    }
+    TEST_ASSERT(mge_reader_register(domain) == MGE_INVALID_READER, "too many readers");
+    for (int i = 0; i < 8; i++) {
+        mge_reader_unregister(domain, readers[i]);
+    }
+
+    return true;
+}
+
+#define NUM_READERS 3
+#define NUM_VALUES 64
+#define NUM_VERSIONS 2000
+
+typedef struct {
+    mga_u64 version;
+    mga_u64 values[NUM_VALUES];
+} index_version;
+
+static index_version* shared_index = NULL;
+static mga_u64 reader_done = 0;
+
+static void* reader_func(void* arg) {
+    bool* valid = (bool*)arg;
+    mga_u32 reader = mge_reader_register(domain);
+
+    while (!__atomic_load_n(&reader_done, __ATOMIC_ACQUIRE)) {
+        mge_pin(domain, reader);
+
+        index_version* index = (index_version*)mge_load_ptr((void**)&shared_index);
+        for (int i = 0; i < NUM_VALUES; i++) {
+            // Reset memory would break this
+            *valid = *valid && index->values[i] == index->version * NUM_VALUES + i;
+        }
+
+        mge_unpin(domain, reader);
+    }
+
+    mge_reader_unregister(domain, reader);
+
+    return NULL;
+}
+
+bool test_threads(void) {
+    index_version* first = MGA_PUSH_STRUCT(mge_get_arena(domain), index_version);
+    first->version = 0;
+    for (int i = 0; i < NUM_VALUES; i++) {
+        first->values[i] = i;
+    }
+    mge_store_ptr((void**)&shared_index, first);
+
+    pthread_t threads[NUM_READERS];
+    bool valid[NUM_READERS];
+    for (int i = 0; i < NUM_READERS; i++) {
+        valid[i] = true;
+        pthread_create(&threads[i], NULL, reader_func, &valid[i]);
+    }
+
+    mga_u64 num_advances = 0;
+    for (mga_u64 v = 1; v < NUM_VERSIONS; v++) {
+        index_version* cur = shared_index;
+        index_version* next = (index_version*)mge_copy(domain, cur, sizeof(index_version));
+        next->version = v;
+        for (int i = 0; i < NUM_VALUES; i++) {
+            next->values[i] = v * NUM_VALUES + i;
+        }
+        mge_store_ptr((void**)&shared_index, next);
+
+        // The reachable version is in the current epoch, so advancing is safe
+        if (mge_try_advance(domain)) {
+            num_advances++;
+
+            // Carry the published version into the new epoch
+            index_version* carried = (index_version*)mge_copy(domain, next, sizeof(index_version));
+            mge_store_ptr((void**)&shared_index, carried);
+        }
+    }
+
+    __atomic_store_n(&reader_done, 1, __ATOMIC_RELEASE);
+    for (int i = 0; i < NUM_READERS; i++) {
+        pthread_join(threads[i], NULL);
+        TEST_ASSERT(valid[i], "readers never see reclaimed memory");
+    }
+
+    TEST_ASSERT(num_advances > 0, "epochs advanced");
+
+    return true;
+}
+
+bool test_destroy(void) {
+    mge_destroy(domain);
+    mga_destroy(arena);
+
+    return true;
+}
+
+#define TEST_XLIST \
+    X(CREATE, create) \
+    X(ADVANCE, advance) \
+    X(THREADS, threads) \
+    X(DESTROY, destroy)
+
+enum {
+#define X(name, func_name) TEST_##name,
+    TEST_XLIST
+#undef X
+    TEST_COUNT
+};
+
+static const char* test_names[TEST_COUNT] = {
+#define X(name, func_name) #name,
+    TEST_XLIST
+#undef X
+};
+
+typedef bool (test_func)(void);
+static test_func* test_funcs[TEST_COUNT] = {
+#define X(name, func_name) test_##func_name,
+    TEST_XLIST
+#undef X
+};
+
+#define RED_BG(s) "\x1b[41m" s "\x1b[0m"
+#define GRN_BG(s) "\x1b[42m" s "\x1b[0m"
+
+int main(int argc, char** argv) {
+    bool quiet = false;
+    for (int i = 0; i < argc; i++) {
+        if (strcmp(argv[i], "-s") == 0)
+            quiet = true;
+    }
+
+    uint32_t num_passed = 0;
+    for (int i = 0; i < TEST_COUNT; i++) {
+        if (test_funcs[i]()) {
+            if (!quiet)
+                printf(GRN_BG("Test passed:") " %s\n", test_names[i]);
+            
+            num_passed++;
+        } else {
+            if (!quiet)
+                printf(RED_BG("Test failed:") " %s\n", test_names[i]);
+        }
+    }
+
+    if (!quiet) { puts(""); }
+    printf("Test Results: " GRN_BG("%d/%d passed") ", " RED_BG("%d/%d failed") ".\n",
+        num_passed, TEST_COUNT, TEST_COUNT - num_passed, TEST_COUNT);
+    
+    return 0;
+}
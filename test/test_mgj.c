@@ -0,0 +1,341 @@
+#include <stdio.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#include <pthread.h>
+
+#define MG_ARENA_IMPL
+#include "../mg_arena.h"
+
+#define MGJ_STATIC
+#define MG_JOBS_IMPL
+#include "../mg_jobs.h"
+
+#define TEST_ASSERT(b, m) \
+    if (!(b)) { printf("\x1b[35mAssert Failed: " m "\x1b[0m\n"); return false; }
+
+static mg_arena* arena;
+static mgj_pool* pool;
+
+void test_error_callback(mga_error err) { 
+    printf("MGA Error %u: %s\n", err.code, err.msg);
+}
+
+bool test_create(void) {
+    arena = mga_create(&(mga_desc){
+        .desired_max_size = MGA_MiB(16),
+        .error_callback = test_error_callback
+    });
+    TEST_ASSERT(arena != NULL, "Arena create");
+
+    pool = mgj_create(arena, &(mgj_desc){
+        .num_threads = 4,
+        .scratch_desc = {
+            .desired_max_size = MGA_MiB(8),
+            .error_callback = test_error_callback
+        }
+    });
+    TEST_ASSERT(pool != NULL, "Pool create");
+    TEST_ASSERT(mgj_get_num_threads(pool) == 4, "Num threads");
+    TEST_ASSERT(mgj_get_thread_index(pool) == 0, "Creator thread index");
+
+    return true;
+}
+
+#define NUM_VALUES 100000
+
+typedef struct {
+    mga_u32* values;
+    mga_u64 sums[4];
+} for_data;
+
+static void square_func(void* arg, mga_u64 start, mga_u64 end, mg_arena* scratch) {
+    for_data* data = (for_data*)arg;
+
+    // Scratch memory is released when the task returns
+    mga_u32* temp = MGA_PUSH_ARRAY(scratch, mga_u32, end - start);
+    for (mga_u64 i = start; i < end; i++) {
+        temp[i - start] = data->values[i] * 2;
+    }
+
+    mga_u64 sum = 0;
+    for (mga_u64 i = start; i < end; i++) {
+        data->values[i] = temp[i - start];
+        sum += temp[i - start];
+    }
+
+    __atomic_fetch_add(&data->sums[mgj_get_thread_index(pool)], sum, __ATOMIC_RELAXED);
+}
+
+bool test_parallel_for(void) {
+    mga_temp temp = mga_temp_begin(arena);
+
+    for_data data = { 0 };
+    data.values = MGA_PUSH_ARRAY(temp.arena, mga_u32, NUM_VALUES);
+    for (mga_u32 i = 0; i < NUM_VALUES; i++) {
+        data.values[i] = i;
+    }
+
+    mga_temp scratch = mga_scratch_get(NULL, 0);
+    mga_u64 scratch_pos = mga_get_pos(scratch.arena);
+    mga_scratch_release(scratch);
+
+    mgj_parallel_for(pool, NUM_VALUES, 1000, square_func, &data);
+
+    bool correct = true;
+    for (mga_u32 i = 0; i < NUM_VALUES; i++) {
+        correct = correct && data.values[i] == i * 2;
+    }
+    TEST_ASSERT(correct, "parallel for values");
+
+    mga_u64 sum = data.sums[0] + data.sums[1] + data.sums[2] + data.sums[3];
+    TEST_ASSERT(sum == (mga_u64)NUM_VALUES * (NUM_VALUES - 1), "parallel for sum");
+
+    scratch = mga_scratch_get(NULL, 0);
+    TEST_ASSERT(mga_get_pos(scratch.arena) == scratch_pos, "scratch released");
+    mga_scratch_release(scratch);
+
+    mga_temp_end(temp);
+
+    return true;
+}
+
+typedef struct {
+    mga_u32 depth;
+    mga_u64* count;
+} tree_node;
+
+static void tree_func(void* arg, mg_arena* scratch) {
+    tree_node* node = (tree_node*)arg;
+    __atomic_fetch_add(node->count, 1, __ATOMIC_RELAXED);
+
+    if (node->depth == 0) {
+        return;
+    }
+
+    // Children live in the scratch memory of this task
+    tree_node* children = MGA_PUSH_ARRAY(scratch, tree_node, 2);
+    mgj_group group = { 0 };
+    for (int i = 0; i < 2; i++) {
+        children[i] = (tree_node){ node->depth - 1, node->count };
+        mgj_run(pool, &group, tree_func, &children[i]);
+    }
+    mgj_wait(pool, &group);
+}
+
+bool test_groups(void) {
+    mga_u64 count = 0;
+    tree_node root = { 10, &count };
+
+    mgj_group group = { 0 };
+    mgj_run(pool, &group, tree_func, &root);
+    mgj_wait(pool, &group);
+
+    TEST_ASSERT(count == (1 << 11) - 1, "nested groups");
+
+    return true;
+}
+
+#define NUM_OUTSIDE_THREADS 4
+
+typedef struct {
+    mga_u32* values;
+    mga_u64 count;
+} outside_data;
+
+static void increment_func(void* arg, mga_u64 start, mga_u64 end, mg_arena* scratch) {
+    (void)scratch;
+    mga_u32* values = (mga_u32*)arg;
+    for (mga_u64 i = start; i < end; i++) {
+        values[i]++;
+    }
+}
+
+static void* outside_thread(void* arg) {
+    outside_data* data = (outside_data*)arg;
+
+    for (int i = 0; i < 16; i++) {
+        mgj_parallel_for(pool, NUM_VALUES, 500, increment_func, data->values);
+    }
+
+    tree_node root = { 6, &data->count };
+    mgj_group group = { 0 };
+    mgj_run(pool, &group, tree_func, &root);
+    mgj_wait(pool, &group);
+
+    return NULL;
+}
+
+bool test_outside_threads(void) {
+    mga_temp temp = mga_temp_begin(arena);
+
+    // Threads that are not part of the pool queue tasks at the same time
+    pthread_t threads[NUM_OUTSIDE_THREADS];
+    outside_data data[NUM_OUTSIDE_THREADS];
+    for (int i = 0; i < NUM_OUTSIDE_THREADS; i++) {
+        data[i].values = MGA_PUSH_ZERO_ARRAY(temp.arena, mga_u32, NUM_VALUES);
+        data[i].count = 0;
+        TEST_ASSERT(pthread_create(&threads[i], NULL, outside_thread, &data[i]) == 0, "outside thread create");
+    }
+
+    // The creating thread keeps using the pool too
+    mga_u64 count = 0;
+    tree_node root = { 10, &count };
+    mgj_group group = { 0 };
+    mgj_run(pool, &group, tree_func, &root);
+    mgj_wait(pool, &group);
+    TEST_ASSERT(count == (1 << 11) - 1, "creating thread groups");
+
+    bool correct = true;
+    for (int i = 0; i < NUM_OUTSIDE_THREADS; i++) {
+        pthread_join(threads[i], NULL);
+
+        correct = correct && data[i].count == (1 << 7) - 1;
+        for (mga_u32 j = 0; j < NUM_VALUES; j++) {
+            correct = correct && data[i].values[j] == 16;
+        }
+    }
+    TEST_ASSERT(correct, "outside thread tasks");
+
+    mga_temp_end(temp);
+
+    return true;
+}
+
+bool test_sort(void) {
+    mga_temp temp = mga_temp_begin(arena);
+
+    float* keys = MGA_PUSH_ARRAY(temp.arena, float, NUM_VALUES);
+    float* expected_keys = MGA_PUSH_ARRAY(temp.arena, float, NUM_VALUES);
+    mga_u32* values = MGA_PUSH_ARRAY(temp.arena, mga_u32, NUM_VALUES);
+    mga_u32* expected_values = MGA_PUSH_ARRAY(temp.arena, mga_u32, NUM_VALUES);
+
+    mga_u32 state = 12345;
+    for (mga_u32 i = 0; i < NUM_VALUES; i++) {
+        state = state * 1664525u + 1013904223u;
+        // Rounded so that there are equal keys
+        keys[i] = (float)((mga_i32)(state >> 20) - 2048) * 0.25f;
+        values[i] = i;
+    }
+    memcpy(expected_keys, keys, sizeof(float) * NUM_VALUES);
+    memcpy(expected_values, values, sizeof(mga_u32) * NUM_VALUES);
+
+    TEST_ASSERT(mga_radix_sort_f32(expected_keys, expected_values, NUM_VALUES), "serial sort");
+    TEST_ASSERT(mgj_radix_sort_f32(pool, keys, values, NUM_VALUES), "parallel sort");
+    TEST_ASSERT(memcmp(keys, expected_keys, sizeof(float) * NUM_VALUES) == 0, "parallel sort keys");
+    TEST_ASSERT(memcmp(values, expected_values, sizeof(mga_u32) * NUM_VALUES) == 0, "parallel sort stable");
+
+    mga_u32* ints = MGA_PUSH_ARRAY(temp.arena, mga_u32, NUM_VALUES);
+    mga_u32* expected_ints = MGA_PUSH_ARRAY(temp.arena, mga_u32, NUM_VALUES);
+    for (mga_u32 i = 0; i < NUM_VALUES; i++) {
+        state = state * 1664525u + 1013904223u;
+        ints[i] = state;
+        expected_ints[i] = state;
+    }
+    TEST_ASSERT(mga_radix_sort_u32(expected_ints, NULL, NUM_VALUES), "serial sort u32");
+    TEST_ASSERT(mgj_radix_sort_u32(pool, ints, NULL, NUM_VALUES), "parallel sort u32");
+    TEST_ASSERT(memcmp(ints, expected_ints, sizeof(mga_u32) * NUM_VALUES) == 0, "parallel sort u32 keys");
+
+    mga_i32* signed_ints = MGA_PUSH_ARRAY(temp.arena, mga_i32, NUM_VALUES);
+    mga_i32* expected_signed = MGA_PUSH_ARRAY(temp.arena, mga_i32, NUM_VALUES);
+    for (mga_u32 i = 0; i < NUM_VALUES; i++) {
+        state = state * 1664525u + 1013904223u;
+        signed_ints[i] = (mga_i32)(state >> 16) - 32768;
+        expected_signed[i] = signed_ints[i];
+        values[i] = i;
+        expected_values[i] = i;
+    }
+    TEST_ASSERT(mga_radix_sort_i32(expected_signed, expected_values, NUM_VALUES), "serial sort i32");
+    TEST_ASSERT(mgj_radix_sort_i32(pool, signed_ints, values, NUM_VALUES), "parallel sort i32");
+    TEST_ASSERT(memcmp(signed_ints, expected_signed, sizeof(mga_i32) * NUM_VALUES) == 0, "parallel sort i32 keys");
+    TEST_ASSERT(memcmp(values, expected_values, sizeof(mga_u32) * NUM_VALUES) == 0, "parallel sort i32 stable");
+    TEST_ASSERT(signed_ints[0] < 0 && signed_ints[NUM_VALUES - 1] >= 0, "parallel sort i32 order");
+
+    for (mga_u32 i = 0; i < NUM_VALUES; i++) {
+        ints[i] = i % 7;
+        expected_ints[i] = i % 7;
+    }
+    mga_prefix_sum_u32(expected_ints, NUM_VALUES);
+    mgj_prefix_sum_u32(pool, ints, NUM_VALUES);
+    TEST_ASSERT(memcmp(ints, expected_ints, sizeof(mga_u32) * NUM_VALUES) == 0, "parallel prefix sum u32");
+
+    for (mga_u32 i = 0; i < NUM_VALUES; i++) {
+        keys[i] = 1.0f;
+    }
+    mgj_prefix_sum_f32(pool, keys, NUM_VALUES);
+    bool correct = true;
+    for (mga_u32 i = 0; i < NUM_VALUES; i++) {
+        correct = correct && keys[i] == (float)(i + 1);
+    }
+    TEST_ASSERT(correct, "parallel prefix sum f32");
+
+    mga_temp_end(temp);
+
+    return true;
+}
+
+bool test_destroy(void) {
+    mgj_destroy(pool);
+    mga_destroy(arena);
+
+    return true;
+}
+
+#define TEST_XLIST \
+    X(CREATE, create) \
+    X(PARALLEL_FOR, parallel_for) \
+    X(GROUPS, groups) \
+    X(OUTSIDE_THREADS, outside_threads) \
+    X(SORT, sort) \
+    X(DESTROY, destroy)
+
+enum {
+#define X(name, func_name) TEST_##name,
+    TEST_XLIST
+#undef X
+    TEST_COUNT
+};
+
+static const char* test_names[TEST_COUNT] = {
+#define X(name, func_name) #name,
+    TEST_XLIST
+#undef X
+};
+
+typedef bool (test_func)(void);
+static test_func* test_funcs[TEST_COUNT] = {
+#define X(name, func_name) test_##func_name,
+    TEST_XLIST
+#undef X
+};
+
+#define RED_BG(s) "\x1b[41m" s "\x1b[0m"
+#define GRN_BG(s) "\x1b[42m" s "\x1b[0m"
+
+int main(int argc, char** argv) {
+    bool quiet = false;
+    for (int i = 0; i < argc; i++) {
+        if (strcmp(argv[i], "-s") == 0)
+            quiet = true;
+    }
+
+    uint32_t num_passed = 0;
+    for (int i = 0; i < TEST_COUNT; i++) {
+        if (test_funcs[i]()) {
+            if (!quiet)
+                printf(GRN_BG("Test passed:") " %s\n", test_names[i]);
+            
+            num_passed++;
+        } else {
+            if (!quiet)
+                printf(RED_BG("Test failed:") " %s\n", test_names[i]);
+        }
+    }
+
+    if (!quiet) { puts(""); }
+    printf("Test Results: " GRN_BG("%d/%d passed") ", " RED_BG("%d/%d failed") ".\n",
+        num_passed, TEST_COUNT, TEST_COUNT - num_passed, TEST_COUNT);
+    
+    return 0;
+}
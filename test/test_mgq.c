@@ -0,0 +1,216 @@
+#include <stdio.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#include <pthread.h>
+
+#define MG_ARENA_IMPL
+#include "../mg_arena.h"
+
+#define MGQ_STATIC
+#define MG_QUEUE_IMPL
+#include "../mg_queue.h"
+
+#define TEST_ASSERT(b, m) \
+    if (!(b)) { printf("\x1b[35mAssert Failed: " m "\x1b[0m\n"); return false; }
+
+static mg_arena* arena;
+
+void test_error_callback(mga_error err) { 
+    printf("MGA Error %u: %s\n", err.code, err.msg);
+}
+
+bool test_create(void) {
+    arena = mga_create(&(mga_desc){
+        .desired_max_size = MGA_MiB(16),
+        .error_callback = test_error_callback
+    });
+
+    TEST_ASSERT(arena != NULL, "Arena create");
+
+    return true;
+}
+
+bool test_spsc(void) {
+    mgq_spsc* queue = mgq_spsc_create(arena, 6);
+    TEST_ASSERT(queue != NULL, "spsc create");
+    TEST_ASSERT(mgq_spsc_get_capacity(queue) == 8, "spsc capacity");
+
+    int values[16];
+    for (int i = 0; i < 16; i++) {
+        values[i] = i;
+        TEST_ASSERT(mgq_spsc_push(queue, &values[i]) == (i < 8), "spsc push");
+    }
+
+    void* item = NULL;
+    for (int i = 0; i < 8; i++) {
+        TEST_ASSERT(mgq_spsc_pop(queue, &item) && item == &values[i], "spsc pop order");
+    }
+    TEST_ASSERT(!mgq_spsc_pop(queue, &item), "spsc empty");
+
+    void* items[16];
+    for (int i = 0; i < 16; i++) {
+        items[i] = &values[i];
+    }
+    TEST_ASSERT(mgq_spsc_push_batch(queue, items, 16) == 8, "spsc push batch");
+
+    void* out[16] = { 0 };
+    TEST_ASSERT(mgq_spsc_pop_batch(queue, out, 5) == 5, "spsc pop batch");
+    TEST_ASSERT(mgq_spsc_pop_batch(queue, out + 5, 16) == 3, "spsc pop batch rest");
+    for (int i = 0; i < 8; i++) {
+        TEST_ASSERT(out[i] == &values[i], "spsc batch order");
+    }
+
+    return true;
+}
+
+bool test_mpsc(void) {
+    mgq_mpsc* queue = mgq_mpsc_create(arena, 8);
+    TEST_ASSERT(queue != NULL, "mpsc create");
+    TEST_ASSERT(mgq_mpsc_get_capacity(queue) == 8, "mpsc capacity");
+
+    int values[16];
+    void* items[16];
+    for (int i = 0; i < 16; i++) {
+        values[i] = i;
+        items[i] = &values[i];
+    }
+
+    TEST_ASSERT(mgq_mpsc_push(queue, items[0]), "mpsc push");
+    TEST_ASSERT(mgq_mpsc_push_batch(queue, items + 1, 15) == 4, "mpsc push batch");
+    TEST_ASSERT(mgq_mpsc_push_batch(queue, items + 5, 11) == 2, "mpsc push batch remainder");
+    TEST_ASSERT(mgq_mpsc_push(queue, items[7]), "mpsc push last");
+    TEST_ASSERT(!mgq_mpsc_push(queue, items[8]), "mpsc full");
+
+    void* out[16] = { 0 };
+    TEST_ASSERT(mgq_mpsc_pop_batch(queue, out, 16) == 8, "mpsc pop batch");
+    for (int i = 0; i < 8; i++) {
+        TEST_ASSERT(out[i] == &values[i], "mpsc order");
+    }
+    TEST_ASSERT(!mgq_mpsc_pop(queue, out), "mpsc empty");
+
+    return true;
+}
+
+#define NUM_PRODUCERS 4
+#define ITEMS_PER_PRODUCER 100000
+
+typedef struct {
+    mgq_mpsc* queue;
+    mga_u64 id;
+} producer_args;
+
+static void* producer_func(void* arg) {
+    producer_args* args = (producer_args*)arg;
+
+    for (mga_u64 i = 0; i < ITEMS_PER_PRODUCER; i++) {
+        // Encode the producer and sequence number in the pointer
+        void* item = (void*)(uintptr_t)((args->id << 32) | (i + 1));
+        while (!mgq_mpsc_push(args->queue, item)) { }
+    }
+
+    return NULL;
+}
+
+bool test_mpsc_threads(void) {
+    mgq_mpsc* queue = mgq_mpsc_create(arena, 256);
+
+    pthread_t threads[NUM_PRODUCERS];
+    producer_args args[NUM_PRODUCERS];
+    for (mga_u64 i = 0; i < NUM_PRODUCERS; i++) {
+        args[i] = (producer_args){ queue, i };
+        pthread_create(&threads[i], NULL, producer_func, &args[i]);
+    }
+
+    mga_u64 next[NUM_PRODUCERS] = { 0 };
+    mga_u64 received = 0;
+    bool in_order = true;
+
+    void* items[32];
+    while (received < NUM_PRODUCERS * ITEMS_PER_PRODUCER) {
+        mga_u32 num = mgq_mpsc_pop_batch(queue, items, 32);
+        for (mga_u32 i = 0; i < num; i++) {
+            mga_u64 value = (mga_u64)(uintptr_t)items[i];
+            mga_u64 id = value >> 32;
+            mga_u64 seq = value & 0xffffffff;
+
+            in_order = in_order && id < NUM_PRODUCERS && seq == next[id] + 1;
+            if (id < NUM_PRODUCERS) {
+                next[id] = seq;
+            }
+        }
+        received += num;
+    }
+
+    for (int i = 0; i < NUM_PRODUCERS; i++) {
+        pthread_join(threads[i], NULL);
+    }
+
+    TEST_ASSERT(in_order, "mpsc per producer order");
+
+    return true;
+}
+
+bool test_destroy(void) {
+    mga_destroy(arena);
+
+    return true;
+}
+
+#define TEST_XLIST \
+    X(CREATE, create) \
+    X(SPSC, spsc) \
+    X(MPSC, mpsc) \
+    X(MPSC_THREADS, mpsc_threads) \
+    X(DESTROY, destroy)
+
+enum {
+#define X(name, func_name) TEST_##name,
+    TEST_XLIST
+#undef X
+    TEST_COUNT
+};
+
+static const char* test_names[TEST_COUNT] = {
+#define X(name, func_name) #name,
+    TEST_XLIST
+#undef X
+};
+
+typedef bool (test_func)(void);
+static test_func* test_funcs[TEST_COUNT] = {
+#define X(name, func_name) test_##func_name,
+    TEST_XLIST
+#undef X
+};
+
+#define RED_BG(s) "\x1b[41m" s "\x1b[0m"
+#define GRN_BG(s) "\x1b[42m" s "\x1b[0m"
+
+int main(int argc, char** argv) {
+    bool quiet = false;
+    for (int i = 0; i < argc; i++) {
+        if (strcmp(argv[i], "-s") == 0)
+            quiet = true;
+    }
+
+    uint32_t num_passed = 0;
+    for (int i = 0; i < TEST_COUNT; i++) {
+        if (test_funcs[i]()) {
+            if (!quiet)
+                printf(GRN_BG("Test passed:") " %s\n", test_names[i]);
+            
+            num_passed++;
+        } else {
+            if (!quiet)
+                printf(RED_BG("Test failed:") " %s\n", test_names[i]);
+        }
+    }
+
+    if (!quiet) { puts(""); }
+    printf("Test Results: " GRN_BG("%d/%d passed") ", " RED_BG("%d/%d failed") ".\n",
+        num_passed, TEST_COUNT, TEST_COUNT - num_passed, TEST_COUNT);
+    
+    return 0;
+}